@@ -3,7 +3,8 @@
 
 #include "types.h"
 
-// Charge les définitions de blocs depuis un fichier
+// Charge les définitions de blocs depuis un fichier, puis leurs textures (assemblées dans
+// l'atlas) et leurs modèles OBP sur les workers du job system
 // Retourne le nombre de blocs chargés (incluant AIR), ou -1 en cas d'erreur
 //int loadBlocksFromFile(const char* filepath, BlockDefinition* blocks, int maxBlocks);
 int parseBlocksFromFile(const char* filepath);
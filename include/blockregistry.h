@@ -0,0 +1,19 @@
+#ifndef BLOCKREGISTRY_H
+#define BLOCKREGISTRY_H
+
+#include "types.h"
+
+// Registre des blocs : table de hachage nom -> ID construite une fois les définitions chargées
+// Les clés pointent sur game.blocks[i].name (une seule copie de chaque nom)
+// Les IDs des blocs utilisés par le code (génération, maillage) sont résolus en même temps
+// dans game.blockIds : les boucles par bloc ne comparent que des entiers
+// Construit sur le thread principal avant le démarrage des workers, lecture seule ensuite
+
+// (Re)construit la table et game.blockIds depuis game.blocks
+void buildBlockRegistry();
+void freeBlockRegistry();
+
+// ID du bloc nommé, -1 s'il n'existe pas (sensible à la casse)
+int findBlockByName(const char* name);
+
+#endif
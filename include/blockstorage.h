@@ -0,0 +1,119 @@
+#ifndef BLOCKSTORAGE_H
+#define BLOCKSTORAGE_H
+
+#include <stdint.h>
+#include "types.h"
+
+// Stockage compressé des blocs d'une section : palette locale + indices bit-packés
+// bitsPerIndex vaut 0 (section uniforme, aucune donnée), 1, 2, 4, 8 ou 16
+// Les indices ne chevauchent jamais deux mots de 64 bits
+
+#define SECTION_VOLUME (SECTION_SIZE * SECTION_SIZE * SECTION_SIZE)
+
+// Index linéaire d'un bloc dans une section (ordre [x][y][z])
+static inline int storageIndex(int x, int y, int z) {
+    return (x * SECTION_SIZE + y) * SECTION_SIZE + z;
+}
+
+// Lecture d'un bloc (coordonnées locales à la section, non vérifiées)
+static inline BlockType getStorageBlock(const BlockStorage* storage, int x, int y, int z) {
+    if(storage->bitsPerIndex == 0) return storage->palette[0];
+    
+    int index = storageIndex(x, y, z);
+    int wordShift = 6 - storage->bitsShift;          // log2(indices par mot)
+    int slot = index & ((1 << wordShift) - 1);
+    uint64_t word = storage->data[index >> wordShift];
+    unsigned paletteIndex = (unsigned)(word >> (slot << storage->bitsShift)) & ((1u << storage->bitsPerIndex) - 1);
+    return storage->palette[paletteIndex];
+}
+
+// Section uniforme d'un seul type (aucun indice stocké)
+static inline int isStorageUniform(const BlockStorage* storage) {
+    return storage->bitsPerIndex == 0;
+}
+
+// Section entièrement vide : rien à mailler ni à tester
+static inline int isStorageEmpty(const BlockStorage* storage) {
+    return storage->bitsPerIndex == 0 && storage->palette[0] == BLOCK_AIR;
+}
+
+// Version publiée de la section s d'un chunk (contenu complet et immuable une fois le chunk prêt)
+// Hors thread principal, la version n'est valide qu'entre epochEnter et epochExit (voir epoch.h)
+static inline const BlockStorage* chunkSection(const Chunk* chunk, int s) {
+    return atomic_load_explicit(&chunk->sections[s], memory_order_acquire);
+}
+
+// Section modifiable en place d'un chunk encore privé au thread principal
+// (allocation, chargement, génération : avant CHUNK_STAGE_READY, invisible des autres threads)
+static inline BlockStorage* privateChunkSection(Chunk* chunk, int s) {
+    return atomic_load_explicit(&chunk->sections[s], memory_order_relaxed);
+}
+
+// Accès par colonne : y de 0 à CHUNK_SIZE_Y - 1 (non vérifié)
+static inline BlockType getChunkBlock(const Chunk* chunk, int x, int y, int z) {
+    return getStorageBlock(chunkSection(chunk, y / SECTION_SIZE), x, y % SECTION_SIZE, z);
+}
+
+// Initialise un stockage uniforme rempli de "type"
+void initStorage(BlockStorage* storage, BlockType type);
+void freeStorage(BlockStorage* storage);
+
+// Stockages alloués, tels que référencés par Chunk.sections
+BlockStorage* createStorage(BlockType type);
+BlockStorage* copyStorage(const BlockStorage* source);
+void destroyStorage(BlockStorage* storage);
+
+// Remplace la section s du chunk par storage (thread principal uniquement)
+// L'ancienne version est retirée : libérée quand plus aucun lecteur ne peut la parcourir
+void publishChunkSection(Chunk* chunk, int s, BlockStorage* storage);
+
+// Remplit tout le stockage avec un seul type (repasse en mode uniforme)
+void fillStorage(BlockStorage* storage, BlockType type);
+
+// Écrit un bloc, agrandit la palette et les indices si nécessaire
+void setStorageBlock(BlockStorage* storage, int x, int y, int z, BlockType type);
+
+// Recalcule la colonne (x, z) du chunk en cherchant son plus haut bloc à partir de fromY
+void scanChunkColumn(Chunk* chunk, int x, int z, int fromY);
+
+// Recalcule toutes les colonnes (les sections vides du haut sont sautées)
+void computeChunkColumns(Chunk* chunk);
+
+// Écriture par colonne : y de 0 à CHUNK_SIZE_Y - 1 (non vérifié, thread principal uniquement)
+// Publie une copie modifiée de la section (copy-on-write) et tient à jour le cache des colonnes
+void setChunkBlock(Chunk* chunk, int x, int y, int z, BlockType type);
+
+// Sections d'un chunk dont le mesh dépend du bloc à la hauteur y : la sienne, et la section
+// voisine si le bloc touche sa face du dessus ou du dessous (bits de Chunk.dirtySections)
+static inline uint16_t blockMeshSections(int y) {
+    int s = y / SECTION_SIZE;
+    uint16_t mask = (uint16_t)(1u << s);
+    if(y % SECTION_SIZE == 0 && s > 0) mask |= (uint16_t)(1u << (s - 1));
+    if(y % SECTION_SIZE == SECTION_SIZE - 1 && s + 1 < CHUNK_SECTIONS) mask |= (uint16_t)(1u << (s + 1));
+    return mask;
+}
+
+// Reconstruit le stockage depuis un tableau plat de SECTION_VOLUME blocs (ordre storageIndex)
+// Chemin rapide pour la génération : palette minimale, aucune réallocation par bloc
+void packStorage(BlockStorage* storage, const BlockType* blocks);
+
+// Décompresse tout le stockage dans un tableau plat de SECTION_VOLUME blocs
+void unpackStorage(const BlockStorage* storage, BlockType* blocks);
+
+// Taille maximale d'une section sérialisée : en-tête + palette (16 bits) + indices
+#define STORAGE_MAX_SERIALIZED_SIZE (3 + SECTION_VOLUME * 2 + SECTION_VOLUME * 2)
+
+// Écrit la section dans out (au moins STORAGE_MAX_SERIALIZED_SIZE octets)
+// Format : bitsPerIndex (1 octet), paletteSize (2 octets), palette (2 octets par type),
+// indices bruts (mots de 64 bits), en ordre natif de la machine
+// Retourne le nombre d'octets écrits
+size_t serializeStorage(const BlockStorage* storage, uint8_t* out);
+
+// Remplace le contenu de la section par des données sérialisées
+// Retourne le nombre d'octets lus, ou -1 si les données sont invalides (section inchangée)
+int deserializeStorage(BlockStorage* storage, const uint8_t* in, size_t size);
+
+// Mémoire occupée par le stockage (palette + indices), en octets
+size_t storageMemoryUsage(const BlockStorage* storage);
+
+#endif
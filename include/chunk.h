@@ -3,9 +3,97 @@
 
 #include "types.h"
 
+// Côté d'une section copiée avec sa bordure d'un bloc
+#define SNAPSHOT_SIZE (SECTION_SIZE + 2)
+
+// Copie des blocs d'une section avec une bordure d'un bloc prise sur les 6 voisins
+typedef struct {
+    int sectionY;    // Index de la section dans la colonne
+    BlockType blocks[SNAPSHOT_SIZE][SNAPSHOT_SIZE][SNAPSHOT_SIZE];
+} SectionSnapshot;
+
+// Copie des sections d'un chunk à remailler (les sections vides ou enfouies sont omises)
+// Permet de construire le mesh hors du thread de rendu sans relire game.world
+typedef struct {
+    uint16_t sectionMask;        // Sections à remailler, copiées ou non
+    SectionSnapshot* sections;   // Par sectionY croissant
+    int sectionCount;
+} ChunkSnapshot;
+
+// Sommet de chunk compressé sur 8 octets, décodé par le vertex shader (createShaderProgram)
+// position : x (9 bits) | z (9 bits) << 9 | y (13 bits) << 18
+//            en 1/16 de bloc relatifs au chunk, décalés de CHUNK_VERTEX_BIAS_XZ / CHUNK_VERTEX_BIAS_Y
+// texture  : u (10 bits) | v (10 bits) << 10 | layer (12 bits) << 20
+//            UV en 1/16 de texture, layer = première couche du bloc dans le texture array
+typedef struct {
+    uint32_t position;
+    uint32_t texture;
+} ChunkVertex;
+
+#define CHUNK_VERTEX_BIAS_XZ 128
+#define CHUNK_VERTEX_BIAS_Y 256
+#define CHUNK_VERTEX_MAX_LAYER 4095
+
+// Les meshs de chunk sont des suites de quads de 4 sommets, dessinés avec un buffer d'indices
+// partagé (GL_UNSIGNED_INT, triangles (0,1,2) et (0,2,3) de chaque quad, voir mesharena.h)
+#define QUAD_INDEX_COUNT(vertexCount) ((vertexCount) / 4 * 6)
+
+// Listes de quads d'un modèle précompilé : 6 directions (0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+)
+// et les quads alignés sur aucun axe, toujours affichés
+#define BAKED_FACE_ALWAYS 6
+#define BAKED_FACE_LISTS 7
+
+// Distance max (en blocs, sur chaque axe) d'un sommet de modèle précompilé à l'origine du bloc
+#define BAKED_MODEL_MAX_EXTENT 8
+
+// Modèle OBP d'un bloc compilé au chargement (compileBlockModels) au format des sommets de chunk
+// Positions relatives au bloc : le mesher copie les faces visibles et ajoute l'offset du bloc
+// (le modèle doit tenir à moins de BAKED_MODEL_MAX_EXTENT blocs de son origine pour que l'ajout
+// ne déborde pas ; compileBlockModels écarte les autres)
+struct BakedModel {
+    float boundsMin[3], boundsMax[3];     // Boîte englobante des sommets (en blocs, avant compression)
+    int faceStart[BAKED_FACE_LISTS + 1];  // Liste f = vertices[faceStart[f] .. faceStart[f + 1]]
+    ChunkVertex vertices[];
+};
+
+// Buffers de travail pour la construction d'un mesh (un jeu par thread worker)
+// Un buffer par passe de rendu (RenderLayer), agrandis à la demande :
+// le coût suit le nombre de sections maillées, pas la hauteur
+typedef struct {
+    ChunkVertex* vertices[RENDER_LAYER_COUNT];
+    int capacity[RENDER_LAYER_COUNT];
+} MeshScratch;
+
+// Résultat CPU d'une construction de mesh, prêt à être uploadé par le thread de rendu
+// Seules les sections de sectionMask sont remplacées, les autres gardent leur mesh
+typedef struct {
+    uint16_t sectionMask;
+    ChunkVertex* vertices[RENDER_LAYER_COUNT];
+    // Mesh de la section s dans la passe l : vertices[l][sectionStart[l][s] .. sectionStart[l][s + 1]]
+    int sectionStart[RENDER_LAYER_COUNT][CHUNK_SECTIONS + 1];
+    
+    TileEntity* tileEntities;    // TileEntities des sections de sectionMask
+    int tileEntityCount;
+} ChunkMeshData;
+
 // Chunk mesh functions
 int isBlockOpaque(BlockType type);
-void rebuildChunkMesh(int cx, int cz);
+void compileBlockModels();
+void freeBlockModels();
+void initMeshScratch(MeshScratch *scratch);
+void freeMeshScratch(MeshScratch *scratch);
+
+// Voisins prêts du chunk (X-, X+, Z-, Z+, NULL si absent) : l'appelant détient game.world->lock
+void getChunkNeighbors(const Chunk *chunk, const Chunk *neighbors[4]);
+
+// Copie les sections de sectionMask à mailler (ni vides, ni enfouies) et leur bordure, sans verrou
+// Hors thread principal : entre epochEnter et epochExit ; chunk et voisins restent alloués
+// jusqu'à la fin de la frame du rendu (releaseRetiredChunks)
+void snapshotChunk(const Chunk *chunk, const Chunk *const neighbors[4], uint16_t sectionMask, ChunkSnapshot *snapshot);
+void freeChunkSnapshot(ChunkSnapshot *snapshot);
+void buildChunkMesh(const ChunkSnapshot *snapshot, MeshScratch *scratch, ChunkMeshData *out);
+void uploadChunkMesh(Chunk *chunk, ChunkMeshData *data);
+void freeChunkMeshData(ChunkMeshData *data);
 void freeChunkMesh(Chunk *chunk);
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef CHUNKMAP_H
+#define CHUNKMAP_H
+
+#include "types.h"
+
+// Table de hachage (cx, cz) -> Chunk* avec pool de chunks recyclés
+
+ChunkMap* createChunkMap(int initialCapacity);
+void destroyChunkMap(ChunkMap* map);
+
+// Recherche sans verrou : réservée au thread principal (seul écrivain)
+// ou à un thread qui tient map->lock
+Chunk* chunkMapGet(ChunkMap* map, int cx, int cz);
+
+// Insertion / retrait (thread principal, prennent map->lock)
+void chunkMapInsert(ChunkMap* map, Chunk* chunk);
+void chunkMapRemove(ChunkMap* map, Chunk* chunk);
+
+// Pool : un chunk alloué est vide (air) et marqué à reconstruire
+Chunk* allocChunk(ChunkMap* map);
+void releaseChunk(ChunkMap* map, Chunk* chunk);
+
+// Chunks retirés de la table en attente de libération des ressources GL
+void retireChunk(ChunkMap* map, Chunk* chunk);
+Chunk* takeRetiredChunks(ChunkMap* map);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+// Récupération par époques des données partagées sans verrou (versions des sections, voir blockstorage.h)
+// Le thread principal publie une nouvelle version par échange atomique puis retire l'ancienne ;
+// une version retirée n'est libérée qu'une fois sortis tous les lecteurs qui ont pu la voir
+// Lecteurs : tout thread autre que le principal, entre epochEnter et epochExit (sections courtes)
+// Écrivain : thread principal uniquement (epochRetire, epochReclaim), qui lit sans protection
+
+#include "jobsystem.h"
+
+// Un emplacement de lecteur par thread du système de jobs (jobThreadSlot) : workers, thread
+// de rendu et tout autre thread lecteur, sans limite propre
+#define EPOCH_MAX_READERS JOB_MAX_THREADS
+
+void epochEnter();
+void epochExit();
+
+// Confie object à release dès que plus aucun lecteur ne peut le lire
+void epochRetire(void* object, void (*release)(void*));
+
+// Avance l'époque et libère les objets retirés devenus inaccessibles (une fois par frame)
+void epochReclaim();
+
+// Libère tous les objets retirés (à l'arrêt, plus aucun lecteur actif)
+void epochReclaimAll();
+
+#endif
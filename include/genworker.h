@@ -0,0 +1,22 @@
+#ifndef GENWORKER_H
+#define GENWORKER_H
+
+#include "types.h"
+
+// Libère les générations terminées et pas encore récupérées (après stopJobSystem)
+void freeGenJobs();
+
+// Confie la génération du chunk au système de jobs (thread principal)
+// Le chunk reste en CHUNK_STAGE_GENERATING jusqu'à la récupération du résultat
+void submitChunkGeneration(Chunk* chunk);
+
+// Installe les blocs générés dans leurs chunks, toujours en CHUNK_STAGE_GENERATING
+// onChunkGenerated est appelé pour chacun et les rend visibles (thread principal)
+// Les résultats des chunks déchargés entre-temps sont ignorés
+// Retourne le nombre de chunks mis à jour
+int collectGeneratedChunks(void (*onChunkGenerated)(Chunk* chunk));
+
+// Nombre de générations soumises et pas encore récupérées
+int pendingGenerationCount();
+
+#endif
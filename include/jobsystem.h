@@ -0,0 +1,58 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <stdatomic.h>
+
+// Système de jobs partagé par tous les sous-systèmes (génération, maillage, chargement...)
+// Un worker par coeur libre, chacun avec sa file à vol de travail : il dépile ses propres
+// jobs (LIFO, données chaudes en cache), puis prend dans la file globale, puis vole les plus
+// anciens jobs des autres workers. Les jobs soumis hors des workers passent par la file
+// globale et démarrent dans leur ordre de soumission (priorités du thread de rendu)
+
+// Emplacements de données par thread (workers et threads qui soumettent ou attendent)
+#define JOB_MAX_THREADS 64
+// Les premiers sont réservés aux workers, les autres threads prennent la suite
+#define JOB_MAX_WORKERS (JOB_MAX_THREADS / 2)
+
+typedef void (*JobFunc)(void* data);
+
+struct Job;
+
+// Compteur de jobs : nombre de jobs associés pas encore terminés
+// Sert à attendre un groupe de jobs (waitForJobs) ou à en faire dépendre d'autres (submitJobAfter)
+typedef struct {
+    atomic_int pending;
+    struct Job* waiters;       // Jobs soumis après ce compteur, libérés quand il tombe à 0
+} JobCounter;
+
+#define JOB_COUNTER_INIT { 0, NULL }
+
+// Démarre les workers (un par coeur, moins le thread principal et le thread de rendu)
+void initJobSystem();
+
+// Termine les jobs restants puis arrête les workers
+void stopJobSystem();
+
+// Nombre de threads workers
+int jobWorkerCount();
+
+// Emplacement du thread appelant (0 à JOB_MAX_THREADS - 1), attribué à sa première demande
+// Les workers ont les emplacements 0 à jobWorkerCount() - 1 ; les autres threads, à partir de
+// JOB_MAX_WORKERS, gardent le leur même s'ils le demandent avant initJobSystem ou le gardent
+// après un arrêt et un redémarrage
+int jobThreadSlot();
+
+// Exécute func(data) sur un worker ; counter (facultatif) compte le job jusqu'à sa fin
+void submitJob(JobFunc func, void* data, JobCounter* counter);
+
+// Comme submitJob, mais le job ne démarre qu'une fois dependency à 0
+void submitJobAfter(JobCounter* dependency, JobFunc func, void* data, JobCounter* counter);
+
+// Attend que counter tombe à 0 en exécutant des jobs en attendant
+void waitForJobs(JobCounter* counter);
+
+// Appelle func(begin, end, data) sur des tranches de [0, count) d'au plus grain éléments,
+// réparties entre les workers ; retourne quand toutes les tranches sont terminées
+void parallelFor(int count, int grain, void (*func)(int begin, int end, void* data), void* data);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LZCODEC_H
+#define LZCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compression LZ77 rapide (format proche de LZ4 bloc), sans dépendance externe
+// Séquence : jeton (4 bits littéraux | 4 bits correspondance), longueurs étendues
+// par octets de 255, littéraux, décalage sur 2 octets (little-endian)
+// La dernière séquence ne contient que des littéraux
+
+// Taille maximale du résultat compressé pour srcSize octets
+static inline size_t lzCompressBound(size_t srcSize) {
+    return srcSize + srcSize / 255 + 16;
+}
+
+// Compresse src dans dst (au moins lzCompressBound(srcSize) octets)
+// Retourne la taille compressée
+size_t lzCompress(const uint8_t* src, size_t srcSize, uint8_t* dst);
+
+// Décompresse exactement dstSize octets
+// Retourne 0 en cas de succès, -1 si les données sont corrompues
+int lzDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MESHARENA_H
+#define MESHARENA_H
+
+#include "types.h"
+#include "chunk.h"
+
+// Arène de sommets partagée par les meshs de tous les chunks (thread de rendu uniquement)
+// Un seul VBO découpé en pages, un seul VAO et le buffer d'indices commun des quads :
+// une passe de rendu entière est dessinée en un glMultiDrawElementsBaseVertex
+// Le vertex shader des chunks lit l'origine du chunk propriétaire de chaque page dans
+// un texture buffer : chunkOrigins[gl_VertexID >> MESH_ARENA_PAGE_SHIFT]
+#define MESH_ARENA_PAGE_SHIFT 8
+#define MESH_ARENA_PAGE_VERTICES (1 << MESH_ARENA_PAGE_SHIFT)
+
+// Unité de texture du texture buffer des origines (l'unité 0 est le texture array des blocs)
+#define MESH_ARENA_ORIGIN_UNIT 1
+
+void initMeshArena();
+void freeMeshArena();
+
+// Remplace le mesh d'une plage par vertexCount sommets du chunk (cx, cz)
+// Les pages de la plage sont réutilisées si elles suffisent, l'arène grandit si besoin
+// Retourne 0 si l'arène ne peut plus grandir (plage vide, mesh non affiché)
+int uploadMeshRange(MeshRange *range, const ChunkVertex *vertices, int vertexCount, int cx, int cz);
+
+// Rend les pages d'une plage à l'arène (sans effet une fois l'arène libérée)
+void releaseMeshRange(MeshRange *range);
+
+// Ajoute une plage à la liste de dessin de la passe en cours
+void queueMeshRange(const MeshRange *range);
+
+// Dessine les plages ajoutées en un seul appel et vide la liste
+void drawQueuedMeshRanges();
+
+#endif
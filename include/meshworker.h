@@ -0,0 +1,28 @@
+#ifndef MESHWORKER_H
+#define MESHWORKER_H
+
+#include "types.h"
+
+// Jobs de mesh en vol par worker : assez pour les occuper, assez peu pour que
+// l'ordre de priorité suive la caméra d'une frame à l'autre
+#define MESH_JOBS_PER_WORKER 2
+
+// Libère les jobs terminés restants et les buffers de travail (après stopJobSystem)
+void freeMeshJobs();
+
+// Copie les sections à reconstruire du chunk (et leur bordure) puis confie leur maillage au système de jobs
+// Appelé par le thread de rendu sans verrou ; neighbors vient de getChunkNeighbors (voir chunk.h)
+void submitChunkMesh(Chunk* chunk, const Chunk* neighbors[4]);
+
+// Vrai tant que le nombre de jobs en vol laisse de la place (thread de rendu uniquement)
+int canSubmitChunkMesh();
+
+// Jobs soumis dont le mesh n'est pas encore uploadé (thread de rendu uniquement)
+int meshJobsInFlight();
+
+// Upload les meshs terminés par les workers jusqu'à deadline (glfwGetTime, thread de rendu)
+// Au moins un mesh par appel ; les suivants attendent la frame suivante
+// Retourne le nombre de chunks mis à jour
+int uploadFinishedMeshes(double deadline);
+
+#endif
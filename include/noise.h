@@ -0,0 +1,44 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <stdint.h>
+
+// Bruit de valeur 2D multi-octaves utilisé par la génération du terrain
+// Les noyaux SIMD calculent plusieurs échantillons à la fois avec exactement les mêmes
+// opérations flottantes que le code scalaire : les résultats sont identiques au bit près
+
+typedef enum {
+    NOISE_KERNEL_SCALAR,
+    NOISE_KERNEL_SSE2,      // 4 échantillons par instruction
+    NOISE_KERNEL_AVX2,      // 8 échantillons par instruction
+    NOISE_KERNEL_COUNT
+} NoiseKernel;
+
+// Valeur pseudo-aléatoire dans ]-1, 1] d'un point entier
+// Arithmétique non signée : débordements définis, même résultat sur toutes les plateformes
+static inline float noise2D(int x, int z, int seed) {
+    uint32_t n = (uint32_t)x + (uint32_t)z * 57u + (uint32_t)seed * 131u;
+    n = (n << 13) ^ n;
+    return (1.0f - ((n * (n * n * 15731u + 789221u) + 1376312589u) & 0x7fffffff) / 1073741824.0f);
+}
+
+// Bruit multi-octaves en un point (version scalaire de référence)
+float perlinNoise2D(float x, float z, int octaves, float persistence, int seed);
+
+// Remplit out[x * depth + z] = perlinNoise2D((originX + x) * scale, (originZ + z) * scale, ...)
+// pour 0 <= x < width et 0 <= z < depth, avec le meilleur noyau supporté par le processeur
+// Thread-safe
+void noiseGrid2D(float* out, int originX, int originZ, int width, int depth,
+                 float scale, int octaves, float persistence, int seed);
+
+// Même calcul avec un noyau imposé (comparaisons et mesures)
+// Retourne -1 si le noyau n'est pas disponible sur ce processeur, 0 sinon
+int noiseGrid2DWithKernel(NoiseKernel kernel, float* out, int originX, int originZ, int width, int depth,
+                          float scale, int octaves, float persistence, int seed);
+
+// Noyaux utilisables sur ce processeur
+int isNoiseKernelSupported(NoiseKernel kernel);
+NoiseKernel bestNoiseKernel();
+const char* noiseKernelName(NoiseKernel kernel);
+
+#endif
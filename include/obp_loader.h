@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <cglm/cglm.h>
+#include "rendercommands.h"
 
 // Structure pour un bone avec pivot
 typedef struct {
@@ -18,8 +19,8 @@ typedef struct {
     int texCoordCount;
     int indexCount;
     
-    // OpenGL buffers (pour le rendu dynamique)
-    unsigned int VAO, VBO, EBO;
+    // Buffers OpenGL (pour le rendu dynamique), créés par le thread de rendu (voir rendercommands.h)
+    GpuMesh* mesh;
 } OBPBone;
 
 // Structure pour une keyframe d'animation
@@ -39,6 +40,23 @@ typedef struct {
     int keyframeCount;
 } OBPAnimation;
 
+// Axes des faces d'un cube (0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+) :
+// axe de la normale puis les deux axes du plan, A et B (0=X, 1=Y, 2=Z)
+extern const int obpCubeFaceAxes[6][3];
+
+// Face d'un modèle cube plein, ramenée sur [0,1]^3 (utilisée par le greedy meshing)
+typedef struct {
+    float corner[6][3];     // Sommets des 2 triangles, dans l'ordre du modèle
+    float uv[6][2];
+    float uvStepA[2];       // Variation de l'UV par bloc le long de axisA
+    float uvStepB[2];       // Variation de l'UV par bloc le long de axisB
+} OBPCubeFace;
+
+typedef struct {
+    float origin[3];        // Coin minimal du cube par rapport à la position du bloc
+    OBPCubeFace faces[6];   // 0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+
+} OBPCubeGeometry;
+
 // Structure complète du modèle OBP
 typedef struct {
     OBPBone* bones;
@@ -46,6 +64,10 @@ typedef struct {
     
     OBPAnimation* animations;
     int animationCount;
+    
+    // Non NULL si le modèle est un cube plein 16x16x16 dont chaque face couvre
+    // exactement une texture : ses faces peuvent être fusionnées et l'UV répété
+    OBPCubeGeometry* cube;
 } OBPModel;
 
 // Fonctions de chargement
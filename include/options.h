@@ -8,6 +8,8 @@ void setRenderDistance(float distance);
 void setFOV(float fov);
 void toggleVSync(int enabled);
 void toggleFpsDisplay(int show);
+void setRebuildBudget(float ms);
+void setTickRate(float rate);
 
 // Afficher les options actuelles
 void printGameOptions();
@@ -0,0 +1,35 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include "types.h"
+
+// Sauvegarde du monde par régions de REGION_SIZE x REGION_SIZE chunks
+// Fichier "<dossier>/r.<rx>.<rz>.reg" :
+//  - table de REGION_SIZE² entrées (secteur de début, nombre de secteurs), 0 = absent
+//  - chunks compressés (lzcodec) alignés sur des secteurs de REGION_SECTOR_SIZE octets
+// Les fichiers sont projetés en mémoire (mmap) et chaque chunk n'est décodé qu'à son chargement
+// Thread principal uniquement
+
+#define REGION_SIZE 32
+#define REGION_SECTOR_SIZE 4096
+
+// Prépare le dossier du monde (créé si absent)
+// Retourne 0 en cas de succès, -1 sinon (le monde ne sera alors pas sauvegardé)
+int initRegionStorage(const char* worldDir);
+
+// Ferme tous les fichiers de région ouverts
+void closeRegionStorage();
+
+// Charge les blocs du chunk (chunk->cx/cz renseignés) depuis sa région
+// Retourne 1 si le chunk était sauvegardé, 0 s'il faut le générer
+int loadChunkFromRegion(Chunk* chunk);
+
+// Écrit le chunk dans sa région (réutilise son emplacement s'il y tient encore)
+// Retourne 0 en cas de succès, -1 sinon
+int saveChunkToRegion(const Chunk* chunk);
+
+// Graine du monde sauvegardé : retourne 1 et remplit seed si elle existe
+int loadWorldSeed(int* seed);
+void saveWorldSeed(int seed);
+
+#endif
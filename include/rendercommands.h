@@ -0,0 +1,41 @@
+#ifndef RENDERCOMMANDS_H
+#define RENDERCOMMANDS_H
+
+// File de commandes GPU : seul le thread de rendu appelle OpenGL
+// N'importe quel thread y poste des créations, uploads et destructions de ressources ;
+// la file prend possession des données CPU transmises et les libère après exécution
+// Les commandes s'exécutent dans l'ordre de leur publication
+
+// Temps max par frame pour exécuter les commandes (au moins une par frame)
+#define RENDER_COMMAND_BUDGET_MS 2.0
+
+// Mesh GPU (VAO + VBO + EBO), rempli par le thread de rendu à l'exécution de sa création
+// Son propriétaire CPU n'en garde qu'un pointeur et le confie à postDeleteMesh :
+// la structure reste valide jusqu'à l'exécution de la destruction
+typedef struct {
+    unsigned int VAO, VBO, EBO;
+} GpuMesh;
+
+// Crée et remplit un mesh au format X Y Z U V (5 floats par sommet) ; mesh à 0 jusqu'à l'exécution
+// Prend possession de vertices et indices
+GpuMesh* postCreateMesh(float* vertices, int vertexCount, unsigned int* indices, int indexCount);
+
+// Détruit le mesh et libère sa structure (après sa création, dans l'ordre de la file)
+void postDeleteMesh(GpuMesh* mesh);
+
+// Crée un texture array RGBA8 avec mipmaps et l'écrit dans *texture à l'exécution
+// *texture doit rester valide jusque-là ; prend possession de pixels
+void postCreateTextureArray(unsigned int* texture, int size, int layers, unsigned char* pixels);
+
+// Détruit la texture *texture et la remet à 0 (lue à l'exécution, après sa création)
+void postDeleteTexture(unsigned int* texture);
+
+// Exécute les commandes en attente jusqu'à deadline (glfwGetTime), au moins une par appel
+// Une deadline négative vide la file (thread de rendu uniquement)
+// Retourne le nombre de commandes exécutées
+int executeRenderCommands(double deadline);
+
+// Libère les commandes jamais exécutées sans appeler OpenGL (à l'arrêt, thread de rendu arrêté)
+void freeRenderCommands();
+
+#endif
@@ -9,12 +9,16 @@ void initGLFW(GLFWwindow **window);
 
 // Shader and rendering functions
 unsigned int createShaderProgram();
+unsigned int createEntityShaderProgram();
 unsigned int createCrosshairShader();
 unsigned int createCrosshairVAO();
-void drawWorld(unsigned int shader);
+void drawWorld(const FrameState *frame, const RenderCamera *camera, unsigned int shader, unsigned int entityShader);
 void drawTileEntities(unsigned int shader);
 void drawCrosshair(unsigned int shader, unsigned int VAO);
 
+// Chunks visibles en attente de remaillage ou en cours (thread de rendu, mis à jour par drawWorld)
+int getRemeshQueueDepth();
+
 // Callbacks
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -10,7 +10,18 @@ void initRenderThread(GLFWwindow* window);
 // Arrête proprement le thread de rendu
 void stopRenderThread();
 
-// Met à jour les matrices de vue/projection depuis le thread principal
-void updateRenderMatrices(float* view, float* projection, float camX, float camY, float camZ, int width, int height);
+// Bit de RenderThreadState.sharedFrame : l'emplacement d'échange contient une frame non lue
+#define FRAME_STATE_FRESH 4
+
+// Emplacement à remplir pour la prochaine frame (thread principal)
+// Il contient une frame plus ancienne : tous les champs doivent être réécrits
+FrameState* beginFrameState();
+
+// Publie l'emplacement rempli sans attendre le rendu (une frame non lue est remplacée)
+void publishFrameState();
+
+// Dernière frame publiée, lue une fois par frame par le thread de rendu
+// Sans nouvelle publication, la frame précédente reste valide
+const FrameState* acquireFrameState();
 
 #endif
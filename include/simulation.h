@@ -0,0 +1,42 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Horloge de la simulation à pas fixe (thread principal uniquement)
+// La logique du jeu avance par ticks de 1 / game.options.tickRate secondes, quelle que soit
+// la fréquence d'affichage ; le thread de rendu interpole entre les deux derniers ticks
+
+// Ticks rattrapés au plus par itération de la boucle principale : au-delà, le retard est
+// abandonné (compté dans droppedTicks) pour ne pas enchaîner des itérations de plus en plus longues
+#define SIMULATION_MAX_CATCHUP_TICKS 5
+
+typedef struct {
+    long ticks;                // Ticks exécutés depuis le démarrage
+    long overruns;             // Ticks plus longs que leur budget (la durée d'un tick)
+    long droppedTicks;         // Ticks abandonnés après un retard trop grand
+    double lastTickMs;         // Coût du dernier tick
+} SimulationStats;
+
+// Démarre l'horloge : le premier tick est dû à l'instant now (glfwGetTime)
+void initSimulationClock(double now);
+
+// Nombre de ticks à exécuter maintenant, de 0 à SIMULATION_MAX_CATCHUP_TICKS
+int simulationTicksDue(double now);
+
+// Durée d'un tick (s), à la fréquence courante
+float simulationTickSeconds();
+
+// Instant programmé du dernier tick dû : l'état simulé correspond à cet instant
+double simulationTickTime();
+
+// Instant programmé du prochain tick (la boucle principale dort jusque-là)
+double simulationNextTickTime();
+
+// Enregistre le coût d'un tick (s), compté en dépassement au-delà de simulationTickSeconds()
+void recordSimulationTick(double seconds);
+
+SimulationStats getSimulationStats();
+
+// Clôt la fenêtre de mesure (une fois par seconde) et affiche son bilan si print
+void reportSimulationStats(int print);
+
+#endif
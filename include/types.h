@@ -2,15 +2,19 @@
 #define TYPES_H
 
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include "obp_loader.h"
 
 #define CHUNK_SIZE_X 16
-#define CHUNK_SIZE_Y 16
+#define CHUNK_SIZE_Y 256   // Hauteur d'une colonne (= hauteur du monde)
 #define CHUNK_SIZE_Z 16
 
-#define WORLD_CHUNKS_X 20
-#define WORLD_CHUNKS_Z 20
+// Une colonne est une pile de sections cubiques de SECTION_SIZE blocs de côté
+#define SECTION_SIZE 16
+#define CHUNK_SECTIONS (CHUNK_SIZE_Y / SECTION_SIZE)
+#define CHUNK_ALL_SECTIONS ((uint16_t)((1u << CHUNK_SECTIONS) - 1))  // Masque de toutes les sections
 
 #define CAM_WIDTH 0.5f
 #define CAM_HEIGHT 1.8f
@@ -31,6 +35,7 @@ typedef struct BlockDefinition BlockDefinition;
 typedef struct RenderThreadState RenderThreadState;
 typedef struct Chunk Chunk;
 typedef struct TileEntity TileEntity;
+typedef struct BakedModel BakedModel;
 
 // Définition du pointeur de fonction pour le rendu d'entité
 // modelMatrix contient déjà la translation (x,y,z) et la rotation de base (N/S/E/W)
@@ -41,9 +46,19 @@ typedef struct {
     BlockType type; 
 } Block;
 
+// Stockage palettisé des blocs d'une section (voir blockstorage.h)
+typedef struct {
+    BlockType* palette;      // Types présents dans la section
+    int paletteSize;
+    int paletteCapacity;
+    int bitsPerIndex;        // 0 = section uniforme (palette[0] partout, data == NULL)
+    int bitsShift;           // log2(bitsPerIndex)
+    uint64_t* data;          // Indices dans la palette, bit-packés
+} BlockStorage;
+
 // Tile Entity (Bloc spécial avec données dynamiques : coffre, four, etc.)
 struct TileEntity {
-    int x, y, z;        // Position locale dans le chunk (0-15)
+    int x, y, z;        // Position locale dans le chunk (x/z : 0-15, y : 0-255)
     BlockType type;     // Type de bloc
     float animState;    // État d'animation (ex: 0.0 fermé -> 1.0 ouvert)
     int rotation;       // Orientation (0=Nord, 1=Est, 2=Sud, 3=Ouest)
@@ -51,40 +66,83 @@ struct TileEntity {
 };
 
 
+// Cache par colonne d'un chunk : rempli par la génération ou au chargement,
+// hauteur et surface tenues à jour par setChunkBlock (voir blockstorage.h)
+// Évite de rééchantillonner le bruit ou de parcourir les sections pour trouver le sol
+typedef struct {
+    uint16_t height[CHUNK_SIZE_X][CHUNK_SIZE_Z];    // Y du plus haut bloc non-air + 1, 0 = colonne vide
+    BlockType surface[CHUNK_SIZE_X][CHUNK_SIZE_Z];  // Type de ce bloc (BLOCK_AIR si colonne vide)
+    float biome[CHUNK_SIZE_X][CHUNK_SIZE_Z];        // Bruit de biome de la colonne, lu par l'étage surface (ne suit pas les modifications)
+} ChunkColumns;
+
+// Étapes de génération d'un chunk (voir genworker.h)
+// Le thread principal fait avancer l'étape sous game.world->lock
+typedef enum {
+    CHUNK_STAGE_GENERATING, // Génération en cours sur un worker
+    CHUNK_STAGE_READY       // Complet : seule étape visible du maillage et du rendu
+} ChunkStage;
+
+// Passe de rendu d'un bloc : chaque chunk a un mesh par passe (colonne 8 de blocks.block)
+typedef enum {
+    RENDER_LAYER_SOLID,        // "solid" : opaque ou test alpha, faces arrière éliminées
+    RENDER_LAYER_CUTOUT,       // "cutout" : végétation, dessinée sans élimination des faces arrière
+    RENDER_LAYER_TRANSLUCENT,  // "translucent" : verre, eau, dessinés en dernier sans écrire la profondeur
+    RENDER_LAYER_COUNT
+} RenderLayer;
+
+// Pages de l'arène de sommets partagée occupées par un mesh (voir mesharena.h)
+typedef struct {
+    int firstPage;
+    int pageCount;     // 0 = aucun mesh
+    int vertexCount;
+} MeshRange;
+
 // Chunk structure
 struct Chunk {
-    Block blocks[CHUNK_SIZE_X][CHUNK_SIZE_Y][CHUNK_SIZE_Z];
+    int cx, cz;            // Coordonnées du chunk (en chunks, peuvent être négatives)
     
-    // Mesh statique (optimisé)
-    unsigned int VAO, VBO;
-    unsigned int transparentVAO, transparentVBO;
-    unsigned int foliageVAO, foliageVBO;
-    int vertexCount;
-    int transparentVertexCount;
-    int foliageVertexCount;
+    // Blocs compressés, une section par tranche de SECTION_SIZE en Y (accès via blockstorage.h)
+    // Une section vide ou pleine de roche ne coûte qu'une entrée de palette
+    // Une fois le chunk prêt, chaque version est immuable : une modification publie une copie
+    // et l'ancienne est libérée quand plus aucun lecteur ne la parcourt (voir epoch.h)
+    _Atomic(BlockStorage*) sections[CHUNK_SECTIONS];
+    ChunkColumns columns;
+    
+    // Mesh statique : une plage de l'arène de sommets par section et par passe de rendu
+    // (une modification ne remaille et ne réuploade que les sections touchées)
+    MeshRange mesh[CHUNK_SECTIONS][RENDER_LAYER_COUNT];
     
     // Entités dynamiques (rendues séparément)
     TileEntity* tileEntities;
     int tileEntityCount;
     int tileEntityCapacity;
     
-    int needsRebuild;
+    ChunkStage genStage;
+    int genJobTicket;      // Job de génération attendu (résultats plus anciens ignorés)
+    
+    _Atomic uint16_t dirtySections; // Bit s : mesh de la section s à reconstruire (vidé par le rendu)
+    int needsSave;       // Modifié depuis son chargement : à écrire dans sa région au déchargement
+    int meshJobPending;  // != 0 : ticket du job en cours de construction par un worker
+    
+    Chunk* nextFree;     // Chaînage dans le pool / la liste des chunks retirés
 };
 
-// Render thread state
-struct RenderThreadState {
-    pthread_t thread;
-    pthread_mutex_t mutex;
-    int running;
-    int shouldExit;
+// Table de hachage des chunks chargés, indexée par (cx, cz) (voir chunkmap.h)
+// Le thread principal est le seul à modifier la table ; il prend le mutex pour écrire
+// Le thread de rendu prend le mutex pour la parcourir
+typedef struct {
+    Chunk** slots;           // Adressage ouvert, sondage linéaire (NULL = vide)
+    int capacity;            // Puissance de 2
+    int count;
+    pthread_mutex_t lock;
     
-    // Données de rendu (protégées par mutex)
-    float viewMatrix[16];
-    float projectionMatrix[16];
-    float cameraX, cameraY, cameraZ;
-    int framebufferWidth, framebufferHeight;
-    int selectedBlockID;
-};
+    // Pool de chunks : allocation par blocs, recyclage via liste libre
+    Chunk** slabs;
+    int slabCount;
+    Chunk* freeChunks;
+    Chunk* retiredChunks;    // Retirés de la table, ressources GL à libérer par le thread de rendu
+    pthread_mutex_t poolLock;
+} ChunkMap;
 
 // Options de jeu configurables
 typedef struct {
@@ -92,16 +150,63 @@ typedef struct {
     float fov;                 // Champ de vision en degrés (ex: 60.0)
     int vsync;                 // VSync activé (1) ou désactivé (0)
     int showFps;               // Afficher les FPS (1) ou non (0)
+    float rebuildBudgetMs;     // Temps max par frame pour uploader et soumettre les meshs (ms)
+    float tickRate;            // Fréquence de la simulation à pas fixe (ticks par seconde)
 } GameOptions;
 
+// Entrées d'une frame du thread de rendu, remplies par le thread principal (voir renderthread.h)
+// Tout nouvel état par frame s'ajoute ici : il voyage avec le reste, sans verrou
+// La position vient des deux derniers ticks de simulation : le rendu interpole entre elles
+typedef struct {
+    float projectionMatrix[16];
+    float previousPosition[3]; // Position du joueur à l'avant-dernier tick
+    float position[3];         // Position du joueur au dernier tick
+    float cameraFront[3];      // Orientation la plus récente (souris, non interpolée)
+    float cameraUp[3];
+    double tickTime;           // Instant programmé du dernier tick (glfwGetTime)
+    float tickSeconds;         // Durée d'un tick
+    int framebufferWidth, framebufferHeight;
+    int selectedBlockID;
+    GameOptions options;       // Copie des options au moment de la frame
+} FrameState;
+
+// Caméra d'une frame, interpolée par le thread de rendu à partir du FrameState
+typedef struct {
+    float viewMatrix[16];
+    float position[3];         // Position de l'œil
+} RenderCamera;
+
+// Render thread state
+struct RenderThreadState {
+    pthread_t thread;
+    int running;
+    atomic_int shouldExit;
+    
+    // Triple buffer sans attente : chaque thread possède un emplacement, le troisième sert
+    // d'échange (index dans sharedFrame, avec FRAME_STATE_FRESH s'il n'a pas encore été lu)
+    FrameState frames[3];
+    atomic_int sharedFrame;
+    int writeFrame;            // Thread principal uniquement
+    int readFrame;             // Thread de rendu uniquement
+};
+
+// IDs des blocs utilisés directement par le code, résolus au chargement (voir blockregistry.h)
+// BLOCK_AIR si le bloc n'est pas défini
+typedef struct {
+    BlockType stone, dirt, grass, flower, glass, log, leaves, sand;
+    BlockType test, testCube;    // Blocs de test posés près du spawn (facultatifs)
+} BlockIds;
+
 // Structure globale du jeu - contient toutes les variables importantes
 typedef struct {
     // === BLOCS ===
     BlockDefinition* blocks;     // Tableau de définitions de blocs
     int blockCount;              // Nombre de blocs chargés
+    BlockIds blockIds;           // IDs pré-résolus des blocs connus
     
     // === MONDE ===
-    Chunk** world;               // Grille de chunks
+    ChunkMap* world;             // Chunks chargés autour du joueur
+    int worldSeed;               // Graine de génération du monde
     unsigned int textureAtlas;   // ID de la texture atlas
     int atlasMaxFrames;          // Nombre max de frames d'animation
     
@@ -114,8 +219,7 @@ typedef struct {
     float velocityY;             // Vélocité verticale (gravité)
     
     // === TIMING ===
-    float deltaTime;             // Temps écoulé depuis la dernière frame
-    float lastFrame;             // Timestamp de la dernière frame
+    float deltaTime;             // Durée du tick de simulation en cours (pas fixe)
     float currentFrameTime;      // Temps actuel précalculé (optimisation pour TileEntities)
     
     // === OPTIONS ===
@@ -128,6 +232,12 @@ typedef struct {
     RenderThreadState* renderThread;  // Thread de rendu
 } GameContext;
 
+// Élimination des faces d'un bloc contre ses voisins (colonne 9 de blocks.block)
+typedef enum {
+    CULL_MODE_FACES,  // "faces" : les faces cachées par un voisin ne sont pas maillées
+    CULL_MODE_NONE    // "none" : toutes les faces du modèle sont maillées (croix de végétation)
+} CullMode;
+
 // Block definition (toutes les propriétés d'un type de bloc)
 struct BlockDefinition {
     BlockType id;
@@ -138,8 +248,12 @@ struct BlockDefinition {
     int transparent; // 1 = voir à travers (feuilles), 0 = opaque
     int translucent; // 1 = translucide (verre, eau), ne rend pas faces internes
     int isDynamic;   // 1 = rendu via drawTileEntities (animé), 0 = rendu statique dans le chunk
+    RenderLayer renderLayer; // Mesh du chunk dans lequel le bloc est maillé
+    CullMode cullMode;
     int animFrames;  // Nombre de frames d'animation (1 = statique)
+    int textureLayer; // Première couche du bloc dans le texture array (fixée par createTextureAtlas)
     OBPModel* model; // Modèle OBP chargé
+    BakedModel* bakedModel; // Modèle précompilé pour les meshs de chunk (voir chunk.h)
     
     // Données de texture préchargées (temporaire avant création atlas)
     unsigned char* pixelData;
@@ -4,19 +4,46 @@
 #include <cglm/cglm.h>
 #include "types.h"
 
+// Nombre maximal de chunks lus depuis les régions par frame (lisse le coût du streaming)
+#define STREAM_CHUNKS_PER_FRAME 4
+
 // Global world data
-extern Chunk **world;
 extern BlockDefinition* BLOCK_DEFINITIONS;
 extern int BLOCK_COUNT;
 extern unsigned int textureAtlas;
 
+// Coordonnée monde -> chunk (division arrondie vers -inf, valide pour les négatifs)
+static inline int worldToChunkX(int worldX) {
+    return (worldX >= 0) ? worldX / CHUNK_SIZE_X : (worldX + 1) / CHUNK_SIZE_X - 1;
+}
+static inline int worldToChunkZ(int worldZ) {
+    return (worldZ >= 0) ? worldZ / CHUNK_SIZE_Z : (worldZ + 1) / CHUNK_SIZE_Z - 1;
+}
+
 // World functions
 void initWorld();
 void freeWorld();
+
+// Chunk complet (CHUNK_STAGE_READY) aux coordonnées données, NULL sinon (thread principal)
+Chunk* getChunk(int cx, int cz);
+
+// Streaming autour du joueur, à appeler à chaque frame (thread principal) :
+// décharge les chunks trop éloignés, récupère les terrains générés par les workers,
+// termine les chunks dont les voisins sont prêts et lance les chargements suivants
+void updateWorld(float playerX, float playerZ);
+
+// Modifie un bloc d'un chunk prêt (thread principal), 0 si le chunk n'est pas chargé
+// Marque les sections touchées du chunk et, en bordure, celles des chunks voisins ;
+// les marques sont regroupées par chunk jusqu'au prochain flushBlockEdits
+int setWorldBlock(int worldX, int worldY, int worldZ, BlockType type);
+
+// Publie les sections à remailler accumulées depuis le dernier appel (une fois par frame)
+void flushBlockEdits();
+
+// Libère les chunks déchargés (thread de rendu : possède les ressources GL)
+void releaseRetiredChunks();
+
 BlockType getBlockAt(int worldX, int worldY, int worldZ);
 int checkCollisionAABB(vec3 newPos);
 
-// Helper: trouve un bloc par son nom, retourne son ID ou -1 si non trouvé
-int findBlockByName(const char* name);
-
 #endif
@@ -3,11 +3,25 @@
 
 #include "chunk.h"
 
-// Génère un monde aléatoire avec du terrain procédural
+// Altitude de base du terrain procédural (roche en dessous, air au-dessus du relief)
+#define TERRAIN_BASE_HEIGHT 64
+
+// Initialise la génération procédurale
 // seed: graine pour la génération (0 = utilise time())
-void generateRandomWorld(Chunk **world, int seed);
+void initWorldGen(int seed);
+
+// Génère le chunk (cx, cz) dans sections (initialisées à l'air) : bruit, surface puis arbres
+// columns reçoit le cache des colonnes (hauteurs, blocs de surface et biomes) tenu par les étages
+// Fonction pure de (seed, cx, cz) : ne lit ni n'écrit le monde, le résultat ne dépend pas
+// de l'ordre de génération des chunks (les arbres de la bordure sont lus dans une marge)
+// Thread-safe : appelé par les workers de génération
+void generateChunk(int cx, int cz, int seed, BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns);
+
+// Étage "biomes" : bruit de biome de chaque colonne du chunk dans columns->biome
+// Ne dépend que de (seed, cx, cz) : appelé par generateChunk et au chargement d'un chunk sauvegardé
+void computeChunkBiomes(int cx, int cz, int seed, ChunkColumns* columns);
 
-// Génère un monde plat simple pour les tests
-void generateFlatWorld(Chunk **world);
+// Génère un chunk plat simple pour les tests
+void generateFlatChunk(Chunk* chunk);
 
 #endif
@@ -5,14 +5,85 @@
 #include "blockparser.h"
 #include "obp_loader.h"
 #include "entities.h"
+#include "blockregistry.h"
 #include <limits.h>
 #include "lodepng/lodepng.h"
+#include "jobsystem.h"
+#include "texture.h"
+
+// Noms des passes de rendu et modes de culling acceptés dans blocks.block
+static const char* renderLayerNames[RENDER_LAYER_COUNT] = { "solid", "cutout", "translucent" };
+static const char* cullModeNames[] = { "faces", "none" };
+
+// Index de name dans names, fallback (avec un avertissement) s'il est inconnu
+static int parseEnumName(const char* name, const char** names, int count, int fallback, const char* blockName) {
+    for(int i = 0; i < count; i++) {
+        if(strcmp(name, names[i]) == 0) return i;
+    }
+    fprintf(stderr, "Warning: valeur '%s' inconnue pour le bloc %s, défaut '%s'\n", name, blockName, names[fallback]);
+    return fallback;
+}
 
 // Charge les définitions de blocs depuis un fichier
 // Format: block_name id solid transparent texture_path
 // Exemple: Stone 1 1 0 textures/stone.png
 // Retourne le nombre total de blocs (incluant AIR)
 
+// Texture d'un bloc à décoder une fois le fichier lu
+typedef struct {
+    int block;
+    char name[64];
+    char path[PATH_MAX + 1];
+} TextureLoad;
+
+// Modèle OBP d'un bloc à charger une fois le fichier lu
+typedef struct {
+    int block;
+    char path[PATH_MAX + 1];
+} ModelLoad;
+
+// Job : chaque bloc a sa texture, les décodages sont indépendants
+static void decodeBlockTexture(void* data) {
+    TextureLoad* load = data;
+    BlockDefinition* block = &game.blocks[load->block];
+    unsigned char* pngData = NULL;
+    size_t pngSize = 0;
+    
+    // Charger le fichier en mémoire
+    if(lodepng_load_file(&pngData, &pngSize, load->path) == 0) {
+        // Décoder complètement l'image et la stocker
+        unsigned error = lodepng_decode32(&block->pixelData, &block->texWidth, &block->texHeight, pngData, pngSize);
+        
+        if(error) {
+            printf("Warning: Impossible de décoder la texture %s (Error %u)\n", load->name, error);
+        }
+        
+        free(pngData);
+    } else {
+        printf("Warning: Impossible de charger le fichier texture %s\n", load->name);
+    }
+}
+
+// Job : dépend de toutes les textures (tailles et frames lues dans pixelData)
+static void assembleTextureAtlas(void* data) {
+    (void)data;
+    createTextureAtlas();
+}
+
+// Job : les modèles ne dépendent pas des textures, ils se chargent pendant les décodages
+static void loadBlockModel(void* data) {
+    ModelLoad* load = data;
+    BlockDefinition* block = &game.blocks[load->block];
+    block->model = loadOBPModel(load->path);
+    if(!block->model) {
+        fprintf(stderr, "ERREUR CRITIQUE: impossible de charger le modèle OBP %s pour %s\n", 
+                load->path, block->name);
+        // On continue au lieu de quitter pour permettre le debug
+    } else {
+        printf("Modèle OBP chargé: %s pour bloc %s\n", load->path, block->name);
+    }
+}
+
 #define S_(x) #x
 #define S(x) S_(x)
 
@@ -27,6 +98,9 @@ int parseBlocksFromFile(const char* filepath) {
         return -1;
     }
 	int i = 1;
+	TextureLoad* textureLoads = NULL;
+	ModelLoad* modelLoads = NULL;
+	int textureCount = 0;
 	char *line = NULL;
 	size_t len = 0;
 	while (getline(&line, &len, fd) > 0) {
@@ -40,11 +114,14 @@ int parseBlocksFromFile(const char* filepath) {
         int isDynamic;
 		char tx_path[64];
 		char model_path[PATH_MAX + 1];
+		char layer_name[16];
+		char cull_name[16];
 		
-		// Lire avec ou sans model path
-        // Format: Name Solid Transp Transluc Dynamic Texture Model
-		int matches = sscanf(line, "%63s %i %i %i %i %"S(PATH_MAX)"s %"S(PATH_MAX)"s", 
-		                     name, &solid, &transparant, &translucent, &isDynamic, tx_path, model_path);
+		// Lire avec ou sans model path, passe de rendu et mode de culling
+        // Format: Name Solid Transp Transluc Dynamic Texture Model Layer Cull
+		int matches = sscanf(line, "%63s %i %i %i %i %"S(PATH_MAX)"s %"S(PATH_MAX)"s %15s %15s", 
+		                     name, &solid, &transparant, &translucent, &isDynamic, tx_path, model_path,
+		                     layer_name, cull_name);
 		
 		if(matches < 6) {
 		    fprintf(stderr, "Erreur: ligne malformée ignorée (attendu 6+ args): %s", line);
@@ -52,42 +129,39 @@ int parseBlocksFromFile(const char* filepath) {
 		}
 		
 		game.blocks = realloc(game.blocks, (i + 1) * sizeof(BlockDefinition));
+        game.blocks[i].id = i;
         game.blocks[i].name = strdup(name);
         game.blocks[i].solid = solid;
         game.blocks[i].transparent = transparant;
         game.blocks[i].translucent = translucent;
         game.blocks[i].isDynamic = isDynamic;
-        game.blocks[i].animFrames = 1;  // Défaut, sera mis à jour dans createTextureAtlas()
-        
-        char full_path[PATH_MAX + 1];
-        snprintf(full_path, PATH_MAX, "textures/%s.png", tx_path);
+        // Sans colonne : les blocs translucides dans leur passe, tous les autres opaques
+        game.blocks[i].renderLayer = (matches >= 8)
+            ? (RenderLayer)parseEnumName(layer_name, renderLayerNames, RENDER_LAYER_COUNT,
+                                         translucent ? RENDER_LAYER_TRANSLUCENT : RENDER_LAYER_SOLID, name)
+            : (translucent ? RENDER_LAYER_TRANSLUCENT : RENDER_LAYER_SOLID);
+        game.blocks[i].cullMode = (matches >= 9)
+            ? (CullMode)parseEnumName(cull_name, cullModeNames, 2, CULL_MODE_FACES, name)
+            : CULL_MODE_FACES;
+        game.blocks[i].animFrames = 1;  // Défaut, mis à jour par l'assemblage de l'atlas
+        game.blocks[i].textureLayer = 0; // Idem
         
-        // Pré-charger les dimensions de la texture pour le modèle
-        unsigned char* pngData = NULL;
-        size_t pngSize = 0;
-        
-        // Initialiser les champs de texture
+        // Initialiser les champs de texture (décodée après la lecture du fichier)
         game.blocks[i].pixelData = NULL;
         game.blocks[i].texWidth = 0;
         game.blocks[i].texHeight = 0;
         
-        // Charger le fichier en mémoire
-        if(lodepng_load_file(&pngData, &pngSize, full_path) == 0) {
-            // Décoder complètement l'image et la stocker
-            unsigned error = lodepng_decode32(&game.blocks[i].pixelData, &game.blocks[i].texWidth, &game.blocks[i].texHeight, pngData, pngSize);
-            
-            if(error) {
-                printf("Warning: Impossible de décoder la texture %s (Error %u)\n", tx_path, error);
-            }
-            
-            free(pngData);
-        } else {
-            printf("Warning: Impossible de charger le fichier texture %s\n", tx_path);
-        }
+        textureLoads = realloc(textureLoads, (i + 1) * sizeof(TextureLoad));
+        TextureLoad* load = &textureLoads[textureCount++];
+        load->block = i;
+        snprintf(load->name, sizeof(load->name), "%s", tx_path);
+        snprintf(load->path, PATH_MAX, "textures/%s.png", tx_path);
 
-
-        // Déterminer le chemin du modèle OBP
-        char full_path_model[PATH_MAX + 1];
+        // Déterminer le chemin du modèle OBP (chargé après la lecture du fichier)
+        modelLoads = realloc(modelLoads, (i + 1) * sizeof(ModelLoad));
+        ModelLoad* model = &modelLoads[textureCount - 1];
+        model->block = i;
+        char* full_path_model = model->path;
         
         // Vérifier si model_path contient déjà l'extension
         if (strstr(model_path, ".obp") != NULL) {
@@ -104,19 +178,9 @@ int parseBlocksFromFile(const char* filepath) {
             snprintf(full_path_model, PATH_MAX, "models/%s.obp", model_path);
         }
         
-        // Initialiser le pointeur
+        // Initialiser les pointeurs
         game.blocks[i].model = NULL;
-        
-        // Charger le modèle OBP
-        game.blocks[i].model = loadOBPModel(full_path_model);
-        if(!game.blocks[i].model) {
-            fprintf(stderr, "ERREUR CRITIQUE: impossible de charger le modèle OBP %s pour %s\n", 
-                    full_path_model, name);
-            // On continue au lieu de quitter pour permettre le debug
-            // exit(1);
-        } else {
-            printf("Modèle OBP chargé: %s pour bloc %s\n", full_path_model, name);
-        }
+        game.blocks[i].bakedModel = NULL;  // Compilé par compileBlockModels()
         
         // Assigner le renderer par défaut (sera surchargé par entityloader si besoin)
         game.blocks[i].renderFunc = renderDefaultDynamic;
@@ -125,7 +189,28 @@ int parseBlocksFromFile(const char* filepath) {
 	}
     game.blockCount = i;
     fclose(fd);
+    free(line);
+    
+    // Ressources chargées sur les workers (game.blocks n'est plus réalloué) :
+    // décodage des textures -> assemblage de l'atlas, et modèles OBP en parallèle des deux
+    JobCounter texturesDecoded = JOB_COUNTER_INIT;
+    JobCounter assetsLoaded = JOB_COUNTER_INIT;
+    for(int t = 0; t < textureCount; t++) {
+        submitJob(decodeBlockTexture, &textureLoads[t], &texturesDecoded);
+    }
+    submitJobAfter(&texturesDecoded, assembleTextureAtlas, NULL, &assetsLoaded);
+    for(int m = 0; m < textureCount; m++) {
+        submitJob(loadBlockModel, &modelLoads[m], &assetsLoaded);
+    }
+    // L'atlas compte dans assetsLoaded dès sa soumission : rien ne rend la main avant lui
+    waitForJobs(&assetsLoaded);
+    free(textureLoads);
+    free(modelLoads);
     printf("Total: %d blocs chargés depuis %s\n", game.blockCount, filepath);
+    
+    // Noms hachés et IDs connus résolus une fois pour toutes
+    buildBlockRegistry();
+    return game.blockCount;
 }
 
 
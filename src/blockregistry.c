@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blockregistry.h"
+
+typedef struct {
+    const char* name;    // NULL = case libre
+    uint32_t hash;
+    BlockType id;
+} RegistryEntry;
+
+static RegistryEntry* entries = NULL;
+static unsigned entryMask = 0;
+
+// FNV-1a 32 bits
+static uint32_t hashBlockName(const char* name) {
+    uint32_t hash = 2166136261u;
+    for(const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+// Bloc indispensable à la génération : absent, il est remplacé par de l'air
+static BlockType resolveRequiredBlock(const char* name) {
+    int id = findBlockByName(name);
+    if(id < 0) {
+        fprintf(stderr, "Attention: bloc '%s' absent de blocks.block, remplacé par de l'air\n", name);
+        return BLOCK_AIR;
+    }
+    return id;
+}
+
+// Bloc facultatif (blocs de test) : 0 s'il est absent
+static BlockType resolveOptionalBlock(const char* name) {
+    int id = findBlockByName(name);
+    return (id < 0) ? BLOCK_AIR : id;
+}
+
+void buildBlockRegistry() {
+    freeBlockRegistry();
+
+    // Taux de remplissage <= 50 % : sondages courts
+    unsigned capacity = 16;
+    while(capacity < (unsigned)game.blockCount * 2) capacity *= 2;
+    entries = calloc(capacity, sizeof(RegistryEntry));
+    entryMask = capacity - 1;
+
+    for(int i = 0; i < game.blockCount; i++) {
+        const char* name = game.blocks[i].name;
+        if(!name) {
+            fprintf(stderr, "ERREUR: game.blocks[%d].name est NULL\n", i);
+            continue;
+        }
+
+        uint32_t hash = hashBlockName(name);
+        unsigned slot = hash & entryMask;
+        while(entries[slot].name) {
+            // Nom en double : le premier défini est gardé (comme l'ancienne recherche linéaire)
+            if(entries[slot].hash == hash && strcmp(entries[slot].name, name) == 0) break;
+            slot = (slot + 1) & entryMask;
+        }
+        if(entries[slot].name) {
+            fprintf(stderr, "Attention: bloc '%s' défini deux fois, ID %d ignoré\n", name, i);
+            continue;
+        }
+
+        entries[slot].name = name;
+        entries[slot].hash = hash;
+        entries[slot].id = i;
+    }
+
+    BlockIds* ids = &game.blockIds;
+    ids->stone = resolveRequiredBlock("Stone");
+    ids->dirt = resolveRequiredBlock("Dirt");
+    ids->grass = resolveRequiredBlock("Grass");
+    ids->flower = resolveRequiredBlock("Flower");
+    ids->glass = resolveRequiredBlock("Glass");
+    ids->log = resolveRequiredBlock("Log");
+    ids->leaves = resolveRequiredBlock("Leaves");
+    ids->sand = resolveRequiredBlock("Sand");
+    ids->test = resolveOptionalBlock("Test");
+    ids->testCube = resolveOptionalBlock("TestCube");
+}
+
+void freeBlockRegistry() {
+    free(entries);
+    entries = NULL;
+    entryMask = 0;
+}
+
+int findBlockByName(const char* name) {
+    if(!entries || !name) return -1;
+
+    uint32_t hash = hashBlockName(name);
+    for(unsigned slot = hash & entryMask; entries[slot].name; slot = (slot + 1) & entryMask) {
+        if(entries[slot].hash == hash && strcmp(entries[slot].name, name) == 0) {
+            return entries[slot].id;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,372 @@
+#include <stdlib.h>
+#include <string.h>
+#include "blockstorage.h"
+#include "epoch.h"
+
+// Nombre de mots de 64 bits pour SECTION_VOLUME indices de "bits" bits
+static inline int storageWordCount(int bits) {
+    return (SECTION_VOLUME * bits + 63) / 64;
+}
+
+static inline unsigned readIndex(const uint64_t* data, int bits, int shift, int index) {
+    int wordShift = 6 - shift;
+    int slot = index & ((1 << wordShift) - 1);
+    return (unsigned)(data[index >> wordShift] >> (slot << shift)) & ((1u << bits) - 1);
+}
+
+static inline void writeIndex(uint64_t* data, int bits, int shift, int index, unsigned value) {
+    int wordShift = 6 - shift;
+    int slot = index & ((1 << wordShift) - 1);
+    int bitPos = slot << shift;
+    uint64_t mask = ((1ULL << bits) - 1) << bitPos;
+    uint64_t* word = &data[index >> wordShift];
+    *word = (*word & ~mask) | ((uint64_t)value << bitPos);
+}
+
+// Plus petite taille d'index (0, 1, 2, 4, 8, 16) capable d'adresser paletteSize entrées
+static void bitsForPalette(int paletteSize, int* bits, int* shift) {
+    *bits = 0;
+    *shift = 0;
+    if(paletteSize <= 1) return;
+    *bits = 1;
+    while((1 << *bits) < paletteSize) {
+        *bits <<= 1;
+        (*shift)++;
+    }
+}
+
+void initStorage(BlockStorage* storage, BlockType type) {
+    memset(storage, 0, sizeof(BlockStorage));
+    storage->palette = malloc(sizeof(BlockType));
+    storage->palette[0] = type;
+    storage->paletteSize = 1;
+    storage->paletteCapacity = 1;
+}
+
+void freeStorage(BlockStorage* storage) {
+    free(storage->palette);
+    free(storage->data);
+    memset(storage, 0, sizeof(BlockStorage));
+}
+
+BlockStorage* createStorage(BlockType type) {
+    BlockStorage* storage = malloc(sizeof(BlockStorage));
+    initStorage(storage, type);
+    return storage;
+}
+
+BlockStorage* copyStorage(const BlockStorage* source) {
+    BlockStorage* copy = malloc(sizeof(BlockStorage));
+    *copy = *source;
+    copy->palette = malloc(source->paletteCapacity * sizeof(BlockType));
+    memcpy(copy->palette, source->palette, source->paletteSize * sizeof(BlockType));
+    if(source->bitsPerIndex > 0) {
+        size_t dataBytes = storageWordCount(source->bitsPerIndex) * sizeof(uint64_t);
+        copy->data = malloc(dataBytes);
+        memcpy(copy->data, source->data, dataBytes);
+    }
+    return copy;
+}
+
+void destroyStorage(BlockStorage* storage) {
+    if(!storage) return;
+    freeStorage(storage);
+    free(storage);
+}
+
+static void releaseStorage(void* storage) {
+    destroyStorage(storage);
+}
+
+void publishChunkSection(Chunk* chunk, int s, BlockStorage* storage) {
+    BlockStorage* old = atomic_exchange(&chunk->sections[s], storage);
+    if(old) epochRetire(old, releaseStorage);
+}
+
+void fillStorage(BlockStorage* storage, BlockType type) {
+    uint64_t* oldData = storage->data;
+
+    storage->bitsPerIndex = 0;
+    storage->bitsShift = 0;
+    storage->data = NULL;
+    storage->palette[0] = type;
+    storage->paletteSize = 1;
+
+    free(oldData);
+}
+
+// Passe à des indices plus larges en recopiant les indices existants
+static void growStorage(BlockStorage* storage) {
+    int oldBits = storage->bitsPerIndex;
+    int oldShift = storage->bitsShift;
+    int newBits = (oldBits == 0) ? 1 : oldBits * 2;
+    int newShift = (oldBits == 0) ? 0 : oldShift + 1;
+
+    uint64_t* newData = calloc(storageWordCount(newBits), sizeof(uint64_t));
+    if(oldBits > 0) {
+        for(int i = 0; i < SECTION_VOLUME; i++) {
+            writeIndex(newData, newBits, newShift, i, readIndex(storage->data, oldBits, oldShift, i));
+        }
+    }
+
+    uint64_t* oldData = storage->data;
+
+    storage->data = newData;
+    storage->bitsShift = newShift;
+    storage->bitsPerIndex = newBits;
+
+    free(oldData);
+}
+
+// Double la capacité de la palette
+static void growPalette(BlockStorage* storage) {
+    storage->paletteCapacity *= 2;
+    storage->palette = realloc(storage->palette, storage->paletteCapacity * sizeof(BlockType));
+}
+
+void setStorageBlock(BlockStorage* storage, int x, int y, int z, BlockType type) {
+    // Chemin rapide : section uniforme déjà de ce type
+    if(storage->bitsPerIndex == 0 && storage->palette[0] == type) return;
+
+    int paletteIndex = -1;
+    for(int i = 0; i < storage->paletteSize; i++) {
+        if(storage->palette[i] == type) {
+            paletteIndex = i;
+            break;
+        }
+    }
+
+    if(paletteIndex < 0) {
+        if(storage->paletteSize >= storage->paletteCapacity) {
+            growPalette(storage);
+        }
+        if(storage->paletteSize >= (1 << storage->bitsPerIndex)) {
+            growStorage(storage);
+        }
+        paletteIndex = storage->paletteSize;
+        storage->palette[storage->paletteSize++] = type;
+    }
+
+    writeIndex(storage->data, storage->bitsPerIndex, storage->bitsShift, storageIndex(x, y, z), (unsigned)paletteIndex);
+}
+
+void packStorage(BlockStorage* storage, const BlockType* blocks) {
+    // Construire la palette : les blocs identiques arrivent par séries (colonnes)
+    uint16_t indices[SECTION_VOLUME];
+    BlockType palette[SECTION_VOLUME];
+    int paletteSize = 0;
+    BlockType lastType = 0;
+    int lastIndex = -1;
+
+    for(int i = 0; i < SECTION_VOLUME; i++) {
+        BlockType type = blocks[i];
+        if(type != lastType || lastIndex < 0) {
+            lastIndex = -1;
+            for(int p = 0; p < paletteSize; p++) {
+                if(palette[p] == type) {
+                    lastIndex = p;
+                    break;
+                }
+            }
+            if(lastIndex < 0) {
+                lastIndex = paletteSize;
+                palette[paletteSize++] = type;
+            }
+            lastType = type;
+        }
+        indices[i] = (uint16_t)lastIndex;
+    }
+
+    int bits, shift;
+    bitsForPalette(paletteSize, &bits, &shift);
+
+    int capacity = 1;
+    while(capacity < paletteSize) capacity <<= 1;
+    BlockType* newPalette = malloc(capacity * sizeof(BlockType));
+    memcpy(newPalette, palette, paletteSize * sizeof(BlockType));
+
+    uint64_t* newData = NULL;
+    if(bits > 0) {
+        newData = calloc(storageWordCount(bits), sizeof(uint64_t));
+        for(int i = 0; i < SECTION_VOLUME; i++) {
+            writeIndex(newData, bits, shift, i, indices[i]);
+        }
+    }
+
+    BlockType* oldPalette = storage->palette;
+    uint64_t* oldData = storage->data;
+
+    storage->palette = newPalette;
+    storage->paletteSize = paletteSize;
+    storage->paletteCapacity = capacity;
+    storage->data = newData;
+    storage->bitsShift = shift;
+    storage->bitsPerIndex = bits;
+
+    free(oldPalette);
+    free(oldData);
+}
+
+void unpackStorage(const BlockStorage* storage, BlockType* blocks) {
+    int bits = storage->bitsPerIndex;
+    if(bits == 0) {
+        BlockType type = storage->palette[0];
+        for(int i = 0; i < SECTION_VOLUME; i++) blocks[i] = type;
+        return;
+    }
+
+    // Décodage mot par mot
+    int perWord = 64 / bits;
+    uint64_t mask = (1ULL << bits) - 1;
+    const BlockType* palette = storage->palette;
+    int i = 0;
+    for(int w = 0; i < SECTION_VOLUME; w++) {
+        uint64_t word = storage->data[w];
+        for(int s = 0; s < perWord && i < SECTION_VOLUME; s++, i++) {
+            blocks[i] = palette[word & mask];
+            word >>= bits;
+        }
+    }
+}
+
+size_t storageMemoryUsage(const BlockStorage* storage) {
+    size_t bytes = storage->paletteCapacity * sizeof(BlockType);
+    if(storage->bitsPerIndex > 0) {
+        bytes += storageWordCount(storage->bitsPerIndex) * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+size_t serializeStorage(const BlockStorage* storage, uint8_t* out) {
+    size_t offset = 0;
+    uint16_t paletteSize = (uint16_t)storage->paletteSize;
+    
+    out[offset++] = (uint8_t)storage->bitsPerIndex;
+    memcpy(out + offset, &paletteSize, sizeof(paletteSize));
+    offset += sizeof(paletteSize);
+    
+    for(int i = 0; i < storage->paletteSize; i++) {
+        uint16_t type = (uint16_t)storage->palette[i];
+        memcpy(out + offset, &type, sizeof(type));
+        offset += sizeof(type);
+    }
+    
+    if(storage->bitsPerIndex > 0) {
+        size_t dataBytes = storageWordCount(storage->bitsPerIndex) * sizeof(uint64_t);
+        memcpy(out + offset, storage->data, dataBytes);
+        offset += dataBytes;
+    }
+    return offset;
+}
+
+int deserializeStorage(BlockStorage* storage, const uint8_t* in, size_t size) {
+    size_t offset = 0;
+    uint16_t paletteSize;
+    
+    if(size < 1 + sizeof(paletteSize)) return -1;
+    int bits = in[offset++];
+    memcpy(&paletteSize, in + offset, sizeof(paletteSize));
+    offset += sizeof(paletteSize);
+    
+    // Mêmes invariants que bitsForPalette : la taille d'index est la plus petite possible
+    int expectedBits, shift;
+    bitsForPalette(paletteSize, &expectedBits, &shift);
+    if(paletteSize == 0 || paletteSize > SECTION_VOLUME || bits != expectedBits) return -1;
+    
+    size_t dataBytes = (bits > 0) ? storageWordCount(bits) * sizeof(uint64_t) : 0;
+    if(size - offset < paletteSize * sizeof(uint16_t) + dataBytes) return -1;
+    
+    int capacity = 1;
+    while(capacity < paletteSize) capacity <<= 1;
+    BlockType* newPalette = malloc(capacity * sizeof(BlockType));
+    for(int i = 0; i < paletteSize; i++) {
+        uint16_t type;
+        memcpy(&type, in + offset, sizeof(type));
+        offset += sizeof(type);
+        newPalette[i] = type;
+    }
+    
+    uint64_t* newData = NULL;
+    if(bits > 0) {
+        newData = malloc(dataBytes);
+        memcpy(newData, in + offset, dataBytes);
+        offset += dataBytes;
+        
+        // Un index hors palette lirait au-delà du tableau : données rejetées
+        if(paletteSize < (1 << bits)) {
+            for(int i = 0; i < SECTION_VOLUME; i++) {
+                if(readIndex(newData, bits, shift, i) >= paletteSize) {
+                    free(newPalette);
+                    free(newData);
+                    return -1;
+                }
+            }
+        }
+    }
+    
+    BlockType* oldPalette = storage->palette;
+    uint64_t* oldData = storage->data;
+    
+    storage->palette = newPalette;
+    storage->paletteSize = paletteSize;
+    storage->paletteCapacity = capacity;
+    storage->data = newData;
+    storage->bitsShift = shift;
+    storage->bitsPerIndex = bits;
+    
+    free(oldPalette);
+    free(oldData);
+    return (int)offset;
+}
+
+void scanChunkColumn(Chunk* chunk, int x, int z, int fromY) {
+    ChunkColumns* columns = &chunk->columns;
+    for(int y = fromY; y >= 0; y--) {
+        const BlockStorage* section = chunkSection(chunk, y / SECTION_SIZE);
+        // Section vide : passer directement à celle du dessous
+        if(isStorageEmpty(section)) {
+            y -= y % SECTION_SIZE;
+            continue;
+        }
+        
+        BlockType type = getStorageBlock(section, x, y % SECTION_SIZE, z);
+        if(type != BLOCK_AIR) {
+            columns->height[x][z] = (uint16_t)(y + 1);
+            columns->surface[x][z] = type;
+            return;
+        }
+    }
+    columns->height[x][z] = 0;
+    columns->surface[x][z] = BLOCK_AIR;
+}
+
+void computeChunkColumns(Chunk* chunk) {
+    int top = CHUNK_SECTIONS - 1;
+    while(top >= 0 && isStorageEmpty(chunkSection(chunk, top))) top--;
+    
+    for(int x = 0; x < CHUNK_SIZE_X; x++) {
+        for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+            scanChunkColumn(chunk, x, z, (top + 1) * SECTION_SIZE - 1);
+        }
+    }
+}
+
+void setChunkBlock(Chunk* chunk, int x, int y, int z, BlockType type) {
+    int s = y / SECTION_SIZE;
+    const BlockStorage* current = chunkSection(chunk, s);
+    if(getStorageBlock(current, x, y % SECTION_SIZE, z) == type) return;
+    
+    // Copie modifiée puis publiée : une lecture en cours garde l'ancienne version intacte
+    BlockStorage* copy = copyStorage(current);
+    setStorageBlock(copy, x, y % SECTION_SIZE, z, type);
+    publishChunkSection(chunk, s, copy);
+    
+    int height = chunk->columns.height[x][z];
+    if(type != BLOCK_AIR && y + 1 >= height) {
+        chunk->columns.height[x][z] = (uint16_t)(y + 1);
+        chunk->columns.surface[x][z] = type;
+    } else if(type == BLOCK_AIR && y + 1 == height) {
+        // Sommet retiré : le nouveau sommet est plus bas
+        scanChunkColumn(chunk, x, z, y - 1);
+    }
+}
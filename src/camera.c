@@ -70,8 +70,9 @@ void processInput(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE)==GLFW_PRESS)
         glfwSetWindowShouldClose(window,1);
     
-    // Options de rendu (touches F1-F4)
-    static int f1Pressed = 0, f2Pressed = 0, f3Pressed = 0, f4Pressed = 0;
+    // Options de rendu et de simulation (touches F1-F8)
+    static int f1Pressed = 0, f2Pressed = 0, f3Pressed = 0, f4Pressed = 0, f5Pressed = 0, f6Pressed = 0;
+    static int f7Pressed = 0, f8Pressed = 0;
     
     // F1: Diminuer la distance de rendu
     if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS && !f1Pressed) {
@@ -100,6 +101,34 @@ void processInput(GLFWwindow *window) {
         printGameOptions();
     }
     if (glfwGetKey(window, GLFW_KEY_F4) == GLFW_RELEASE) f4Pressed = 0;
+    
+    // F5: Diminuer le budget de remaillage par frame
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS && !f5Pressed) {
+        f5Pressed = 1;
+        setRebuildBudget(game.options.rebuildBudgetMs - 1.0f);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_RELEASE) f5Pressed = 0;
+    
+    // F6: Augmenter le budget de remaillage par frame
+    if (glfwGetKey(window, GLFW_KEY_F6) == GLFW_PRESS && !f6Pressed) {
+        f6Pressed = 1;
+        setRebuildBudget(game.options.rebuildBudgetMs + 1.0f);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F6) == GLFW_RELEASE) f6Pressed = 0;
+    
+    // F7: Diminuer la fréquence de la simulation
+    if (glfwGetKey(window, GLFW_KEY_F7) == GLFW_PRESS && !f7Pressed) {
+        f7Pressed = 1;
+        setTickRate(game.options.tickRate - 10.0f);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F7) == GLFW_RELEASE) f7Pressed = 0;
+    
+    // F8: Augmenter la fréquence de la simulation
+    if (glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS && !f8Pressed) {
+        f8Pressed = 1;
+        setTickRate(game.options.tickRate + 10.0f);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F8) == GLFW_RELEASE) f8Pressed = 0;
 
     // Cycle blocks (Arrow Keys)
     static int leftPressed = 0, rightPressed = 0;
@@ -137,8 +166,6 @@ void mouse_callback(GLFWwindow* window,double xpos,double ypos){
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
-    extern Chunk **world;
-    
     if(action != GLFW_PRESS) return;
     
     // Position des yeux du joueur (exactement la même que la caméra de rendu)
@@ -166,20 +193,8 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
         
         if(button == GLFW_MOUSE_BUTTON_LEFT) {
             // Détruire le bloc
-            int cx = hx >= 0 ? hx / CHUNK_SIZE_X : (hx - CHUNK_SIZE_X + 1) / CHUNK_SIZE_X;
-            int cz = hz >= 0 ? hz / CHUNK_SIZE_Z : (hz - CHUNK_SIZE_Z + 1) / CHUNK_SIZE_Z;
-            
-            if(cx >= 0 && cx < WORLD_CHUNKS_X && cz >= 0 && cz < WORLD_CHUNKS_Z && hy >= 0 && hy < CHUNK_SIZE_Y) {
-                int lx = hx - cx * CHUNK_SIZE_X;
-                int lz = hz - cz * CHUNK_SIZE_Z;
-                if(lx < 0) lx += CHUNK_SIZE_X;
-                if(lz < 0) lz += CHUNK_SIZE_Z;
-                
-                if(lx >= 0 && lx < CHUNK_SIZE_X && lz >= 0 && lz < CHUNK_SIZE_Z) {
-                    game.world[cx][cz].blocks[lx][hy][lz].type = BLOCK_AIR;
-                    game.world[cx][cz].needsRebuild = 1;
-                    printf("✓ Block destroyed\n");
-                }
+            if(setWorldBlock(hx, hy, hz, BLOCK_AIR)) {
+                printf("✓ Block destroyed\n");
             }
         }
         else if(button == GLFW_MOUSE_BUTTON_RIGHT) {
@@ -199,29 +214,15 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
                 return;
             }
             
-            if(py >= 0 && py < CHUNK_SIZE_Y) {
-                int cx = px >= 0 ? px / CHUNK_SIZE_X : (px - CHUNK_SIZE_X + 1) / CHUNK_SIZE_X;
-                int cz = pz >= 0 ? pz / CHUNK_SIZE_Z : (pz - CHUNK_SIZE_Z + 1) / CHUNK_SIZE_Z;
-                
-                if(cx >= 0 && cx < WORLD_CHUNKS_X && cz >= 0 && cz < WORLD_CHUNKS_Z) {
-                    int lx = px - cx * CHUNK_SIZE_X;
-                    int lz = pz - cz * CHUNK_SIZE_Z;
-                    if(lx < 0) lx += CHUNK_SIZE_X;
-                    if(lz < 0) lz += CHUNK_SIZE_Z;
-                    
-                    if(lx >= 0 && lx < CHUNK_SIZE_X && lz >= 0 && lz < CHUNK_SIZE_Z) {
-                        if(game.world[cx][cz].blocks[lx][py][lz].type == BLOCK_AIR) {
-                            // Use selected block
-                            if(game.selectedBlockID > 0 && game.selectedBlockID < game.blockCount) {
-                                game.world[cx][cz].blocks[lx][py][lz].type = game.selectedBlockID;
-                                printf("✓ %s placed\n", game.blocks[game.selectedBlockID].name);
-                                game.world[cx][cz].needsRebuild = 1;
-                            }
-                        } else {
-                            printf("✗ Can't place: position not empty\n");
-                        }
-                    }
-                }
+            if(getBlockAt(px, py, pz) != BLOCK_AIR) {
+                printf("✗ Can't place: position not empty\n");
+                return;
+            }
+            
+            // Use selected block
+            if(game.selectedBlockID > 0 && game.selectedBlockID < game.blockCount &&
+               setWorldBlock(px, py, pz, game.selectedBlockID)) {
+                printf("✓ %s placed\n", game.blocks[game.selectedBlockID].name);
             }
         }
     } else {
@@ -230,5 +231,6 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 }
 
 void framebuffer_size_callback(GLFWwindow* window,int width,int height){ 
-    glViewport(0,0,width,height); 
+    // Rien à faire ici : le thread de rendu applique la taille publiée dans chaque FrameState
+    (void)window; (void)width; (void)height;
 }
@@ -5,334 +5,772 @@
 #include <math.h>
 #include "chunk.h"
 #include "world.h"
+#include "chunkmap.h"
 #include "obp_loader.h"
+#include "blockstorage.h"
+#include "mesharena.h"
 
-// Ajoute un modèle OBP au mesh (bake la géométrie depuis les données CPU)
-static inline void addOBPModel(float *vertices, int *index, int x, int y, int z, OBPModel* model, BlockType blockType, uint8_t visibleMask) {
-    if(!model) return;
+// Quantifie une valeur en 1/16 et la borne au champ de bits (une valeur hors champ
+// déborderait sur ses voisins)
+static inline uint32_t packSixteenths(float value, int bias, uint32_t maxValue) {
+    long q = lrintf(value * 16.0f) + bias;
+    if(q < 0) q = 0;
+    if(q > (long)maxValue) q = maxValue;
+    return (uint32_t)q;
+}
+
+// Compresse les sommets d'un quad (positions en blocs relatives au chunk)
+// L'UV est ramené près de 0 par un décalage entier commun à tous les sommets :
+// invisible grâce à GL_REPEAT, il garde les UV des faces répétées dans leurs 10 bits
+static inline void addPackedVertices(ChunkVertex *vertices, int *index, const float (*pos)[3], const float (*uv)[2],
+                                     int count, int textureLayer) {
+    float minU = uv[0][0], minV = uv[0][1];
+    for(int k = 1; k < count; k++) {
+        if(uv[k][0] < minU) minU = uv[k][0];
+        if(uv[k][1] < minV) minV = uv[k][1];
+    }
+    float shiftU = floorf(minU), shiftV = floorf(minV);
+    
+    for(int k = 0; k < count; k++) {
+        ChunkVertex *v = &vertices[(*index)++];
+        v->position = packSixteenths(pos[k][0], CHUNK_VERTEX_BIAS_XZ, 511)
+                    | packSixteenths(pos[k][2], CHUNK_VERTEX_BIAS_XZ, 511) << 9
+                    | packSixteenths(pos[k][1], CHUNK_VERTEX_BIAS_Y, 8191) << 18;
+        v->texture = packSixteenths(uv[k][0] - shiftU, 0, 1023)
+                   | packSixteenths(uv[k][1] - shiftV, 0, 1023) << 10
+                   | (uint32_t)textureLayer << 20;
+    }
+}
+
+// Deux sommets identiques (position et UV)
+static inline int sameVertex(const float *posA, const float *uvA, const float *posB, const float *uvB) {
+    return posA[0] == posB[0] && posA[1] == posB[1] && posA[2] == posB[2] && uvA[0] == uvB[0] && uvA[1] == uvB[1];
+}
+
+// Assemble deux triangles (sommets 0-2 et 3-5) qui partagent une arête en un quad de 4 sommets
+// dont les triangles (0,1,2) et (0,2,3) du motif d'indices sont ceux d'origine, même sens
+// Retourne 0 s'ils ne forment pas un quad
+static int pairTriangles(const float (*pos)[3], const float (*uv)[2], float quadPos[4][3], float quadUv[4][2]) {
+    for(int r = 0; r < 3; r++) {
+        int a = r, b = (r + 1) % 3, c = (r + 2) % 3;
+        for(int s = 0; s < 3; s++) {
+            int first = 3 + s, second = 3 + (s + 1) % 3, third = 3 + (s + 2) % 3;
+            if(!sameVertex(pos[a], uv[a], pos[first], uv[first])) continue;
+            if(!sameVertex(pos[c], uv[c], pos[second], uv[second])) continue;
+            
+            int order[4] = { a, b, c, third };
+            for(int k = 0; k < 4; k++) {
+                memcpy(quadPos[k], pos[order[k]], sizeof(quadPos[k]));
+                memcpy(quadUv[k], uv[order[k]], sizeof(quadUv[k]));
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Ajoute deux triangles formant un quad (4 sommets, un seul décalage d'UV)
+// Retourne 0 sans rien écrire s'ils ne forment pas un quad
+static inline int addPackedTrianglePair(ChunkVertex *vertices, int *index, const float (*pos)[3], const float (*uv)[2],
+                                        int textureLayer) {
+    float quadPos[4][3], quadUv[4][2];
+    if(!pairTriangles(pos, uv, quadPos, quadUv)) return 0;
+    addPackedVertices(vertices, index, (const float (*)[3])quadPos, (const float (*)[2])quadUv, 4, textureLayer);
+    return 1;
+}
+
+// Ajoute un triangle isolé sous forme de quad dégénéré : le 4e sommet répète le 3e,
+// le second triangle du motif est vide
+static inline void addPackedTriangle(ChunkVertex *vertices, int *index, const float (*pos)[3], const float (*uv)[2],
+                                     int textureLayer) {
+    float quadPos[4][3], quadUv[4][2];
+    for(int k = 0; k < 4; k++) {
+        memcpy(quadPos[k], pos[k < 3 ? k : 2], sizeof(quadPos[k]));
+        memcpy(quadUv[k], uv[k < 3 ? k : 2], sizeof(quadUv[k]));
+    }
+    addPackedVertices(vertices, index, (const float (*)[3])quadPos, (const float (*)[2])quadUv, 4, textureLayer);
+}
+
+// Plus grand nombre de sommets d'un modèle précompilé (borne le mesh d'une section)
+static int maxBakedModelVertices = 24;
+
+// Direction de la face d'un triangle d'après sa normale (0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+)
+// BAKED_FACE_ALWAYS s'il n'est aligné sur aucun axe (toujours affiché)
+static int classifyTriangle(const float v0[3], const float v1[3], const float v2[3]) {
+    float edge1[3] = { v1[0]-v0[0], v1[1]-v0[1], v1[2]-v0[2] };
+    float edge2[3] = { v2[0]-v0[0], v2[1]-v0[1], v2[2]-v0[2] };
+    
+    float normal[3];
+    normal[0] = edge1[1]*edge2[2] - edge1[2]*edge2[1];
+    normal[1] = edge1[2]*edge2[0] - edge1[0]*edge2[2];
+    normal[2] = edge1[0]*edge2[1] - edge1[1]*edge2[0];
     
-    float bType = (float)blockType;
+    float absX = (normal[0] > 0) ? normal[0] : -normal[0];
+    float absY = (normal[1] > 0) ? normal[1] : -normal[1];
+    float absZ = (normal[2] > 0) ? normal[2] : -normal[2];
+    
+    // Seuil pour considérer qu'une face est alignée (éviter les faces internes diagonales)
+    if (absX > absY && absX > absZ) return (normal[0] > 0) ? 3 : 2;
+    if (absY > absX && absY > absZ) return (normal[1] > 0) ? 5 : 4;
+    if (absZ > absX && absZ > absY) return (normal[2] > 0) ? 0 : 1;
+    return BAKED_FACE_ALWAYS;
+}
+
+// Précompile le modèle OBP d'un bloc : quads triés par direction de face, au format
+// des sommets de chunk, positions relatives au bloc, avec la boîte englobante du modèle
+// Deux triangles consécutifs d'une même liste qui partagent une arête (les faces quad du
+// modèle) deviennent un quad, les autres triangles des quads dégénérés
+static BakedModel* bakeBlockModel(const OBPModel *model, int textureLayer) {
+    int maxTriangles = 0;
+    for(int b = 0; b < model->boneCount; b++) maxTriangles += model->bones[b].indexCount / 3;
+    if(maxTriangles == 0) maxTriangles = 1;
+    
+    // Triangles valides du modèle, positions en blocs
+    float (*pos)[3] = malloc(maxTriangles * 3 * sizeof(*pos));
+    float (*uv)[2] = malloc(maxTriangles * 3 * sizeof(*uv));
+    int *lists = malloc(maxTriangles * sizeof(int));
+    int triangleCount = 0;
     
-    // Parcourir tous les bones du modèle OBP
     for(int b = 0; b < model->boneCount; b++) {
-        OBPBone* bone = &model->bones[b];
+        const OBPBone* bone = &model->bones[b];
         if(bone->indexCount == 0) continue;
         if(!bone->vertices || !bone->indices) continue;
         
-        // Copier chaque triangle (via les indices)
-        for(int i = 0; i < bone->indexCount; i += 3) {
-            if (i + 2 >= bone->indexCount) break;
-            
-            unsigned int idx0 = bone->indices[i];
-            unsigned int idx1 = bone->indices[i+1];
-            unsigned int idx2 = bone->indices[i+2];
+        for(int i = 0; i + 2 < bone->indexCount; i += 3) {
+            unsigned int indices[3] = { bone->indices[i], bone->indices[i+1], bone->indices[i+2] };
             
             // Vérification de sécurité
-            if (idx0 >= bone->vertexCount || idx1 >= bone->vertexCount || idx2 >= bone->vertexCount) {
+            if (indices[0] >= bone->vertexCount || indices[1] >= bone->vertexCount || indices[2] >= bone->vertexCount) {
                 continue;
             }
             
-            // Calcul de la normale pour le culling
-            float v0[3] = { bone->vertices[idx0*3], bone->vertices[idx0*3+1], bone->vertices[idx0*3+2] };
-            float v1[3] = { bone->vertices[idx1*3], bone->vertices[idx1*3+1], bone->vertices[idx1*3+2] };
-            float v2[3] = { bone->vertices[idx2*3], bone->vertices[idx2*3+1], bone->vertices[idx2*3+2] };
-            
-            float edge1[3] = { v1[0]-v0[0], v1[1]-v0[1], v1[2]-v0[2] };
-            float edge2[3] = { v2[0]-v0[0], v2[1]-v0[1], v2[2]-v0[2] };
-            
-            float normal[3];
-            normal[0] = edge1[1]*edge2[2] - edge1[2]*edge2[1];
-            normal[1] = edge1[2]*edge2[0] - edge1[0]*edge2[2];
-            normal[2] = edge1[0]*edge2[1] - edge1[1]*edge2[0];
-            
-            // Déterminer la face (0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+)
-            int faceDir = -1;
-            float absX = (normal[0] > 0) ? normal[0] : -normal[0];
-            float absY = (normal[1] > 0) ? normal[1] : -normal[1];
-            float absZ = (normal[2] > 0) ? normal[2] : -normal[2];
-            
-            // Seuil pour considérer qu'une face est alignée (éviter les faces internes diagonales)
-            if (absX > absY && absX > absZ) {
-                faceDir = (normal[0] > 0) ? 3 : 2;
-            } else if (absY > absX && absY > absZ) {
-                faceDir = (normal[1] > 0) ? 5 : 4;
-            } else if (absZ > absX && absZ > absY) {
-                faceDir = (normal[2] > 0) ? 0 : 1;
-            }
-            
-            // Si la face est alignée sur un axe, vérifier le masque de visibilité
-            if (faceDir != -1) {
-                if (!((visibleMask >> faceDir) & 1)) continue; // Face cachée
-            }
-            
-            // Ajouter les 3 vertices du triangle
-            unsigned int indices[3] = {idx0, idx1, idx2};
-            for(int k=0; k<3; k++) {
+            float (*triPos)[3] = &pos[triangleCount * 3];
+            float (*triUv)[2] = &uv[triangleCount * 3];
+            for(int k = 0; k < 3; k++) {
                 unsigned int idx = indices[k];
-                
-                // Position
-                vertices[(*index)++] = (bone->vertices[idx * 3 + 0] / 16.0f) + x;
-                vertices[(*index)++] = (bone->vertices[idx * 3 + 1] / 16.0f) + y;
-                vertices[(*index)++] = (bone->vertices[idx * 3 + 2] / 16.0f) + z;
-                
-                // UV
+                triPos[k][0] = bone->vertices[idx * 3 + 0] / 16.0f;
+                triPos[k][1] = bone->vertices[idx * 3 + 1] / 16.0f;
+                triPos[k][2] = bone->vertices[idx * 3 + 2] / 16.0f;
                 if (idx < bone->texCoordCount) {
-                    vertices[(*index)++] = bone->texCoords[idx * 2 + 0];
-                    vertices[(*index)++] = bone->texCoords[idx * 2 + 1];
+                    triUv[k][0] = bone->texCoords[idx * 2 + 0];
+                    triUv[k][1] = bone->texCoords[idx * 2 + 1];
                 } else {
-                    vertices[(*index)++] = 0.0f;
-                    vertices[(*index)++] = 0.0f;
+                    triUv[k][0] = 0.0f;
+                    triUv[k][1] = 0.0f;
                 }
-                
-                // Type
-                vertices[(*index)++] = bType;
             }
+            lists[triangleCount++] = classifyTriangle(triPos[0], triPos[1], triPos[2]);
         }
     }
-}
-
-// Vérifie si une face de cube devrait être rendue (face culling intelligent)
-static inline int shouldRenderCubeFace(Chunk *chunk, int cx, int cz, int x, int y, int z, BlockType currentType, int faceDir) {
-    // faceDir: 0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+
-    int nx = x, ny = y, nz = z;
-    int ncx = cx, ncz = cz;  // Chunk voisin
     
-    switch(faceDir) {
-        case 0: nz++; break;  // Z+
-        case 1: nz--; break;  // Z-
-        case 2: nx--; break;  // X-
-        case 3: nx++; break;  // X+
-        case 4: ny--; break;  // Y-
-        case 5: ny++; break;  // Y+
+    // Au plus 4 sommets par triangle, taille ajustée une fois les quads assemblés
+    BakedModel *baked = malloc(sizeof(BakedModel) + maxTriangles * 4 * sizeof(ChunkVertex));
+    for(int k = 0; k < 3; k++) {
+        baked->boundsMin[k] = (triangleCount > 0) ? pos[0][k] : 0.0f;
+        baked->boundsMax[k] = baked->boundsMin[k];
     }
-    
-    // Vérifier si on sort du chunk et aller dans le chunk voisin
-    if(nx < 0) { ncx--; nx = CHUNK_SIZE_X - 1; }
-    else if(nx >= CHUNK_SIZE_X) { ncx++; nx = 0; }
-    
-    if(nz < 0) { ncz--; nz = CHUNK_SIZE_Z - 1; }
-    else if(nz >= CHUNK_SIZE_Z) { ncz++; nz = 0; }
-    
-    // Hors limites du monde = afficher
-    if(ncx < 0 || ncx >= WORLD_CHUNKS_X || ncz < 0 || ncz >= WORLD_CHUNKS_Z) {
-        return 1;
+    for(int v = 0; v < triangleCount * 3; v++) {
+        for(int k = 0; k < 3; k++) {
+            if(pos[v][k] < baked->boundsMin[k]) baked->boundsMin[k] = pos[v][k];
+            if(pos[v][k] > baked->boundsMax[k]) baked->boundsMax[k] = pos[v][k];
+        }
     }
     
-    // Hors limites Y = afficher
-    if(ny < 0 || ny >= CHUNK_SIZE_Y) {
-        return 1;
+    int index = 0;
+    for(int f = 0; f < BAKED_FACE_LISTS; f++) {
+        baked->faceStart[f] = index;
+        int pending = -1;  // Triangle de la liste en attente de son voisin
+        
+        for(int t = 0; t < triangleCount; t++) {
+            if(lists[t] != f) continue;
+            if(pending >= 0) {
+                float pairPos[6][3], pairUv[6][2];
+                memcpy(pairPos, pos[pending * 3], sizeof(pairPos) / 2);
+                memcpy(pairPos[3], pos[t * 3], sizeof(pairPos) / 2);
+                memcpy(pairUv, uv[pending * 3], sizeof(pairUv) / 2);
+                memcpy(pairUv[3], uv[t * 3], sizeof(pairUv) / 2);
+                if(addPackedTrianglePair(baked->vertices, &index, (const float (*)[3])pairPos,
+                                         (const float (*)[2])pairUv, textureLayer)) {
+                    pending = -1;
+                    continue;
+                }
+                addPackedTriangle(baked->vertices, &index, (const float (*)[3])pos[pending * 3],
+                                  (const float (*)[2])uv[pending * 3], textureLayer);
+            }
+            pending = t;
+        }
+        if(pending >= 0) {
+            addPackedTriangle(baked->vertices, &index, (const float (*)[3])pos[pending * 3],
+                              (const float (*)[2])uv[pending * 3], textureLayer);
+        }
     }
+    baked->faceStart[BAKED_FACE_LISTS] = index;
     
-    // Récupérer le bloc adjacent (possiblement dans un autre chunk)
-    Chunk *adjacentChunk = (ncx == cx && ncz == cz) ? chunk : &game.world[ncx][ncz];
-    BlockType adjacentType = adjacentChunk->blocks[nx][ny][nz].type;
-    
-    // Adjacent à l'air = afficher
-    if(adjacentType == BLOCK_AIR) return 1;
-    
-    // Sécurité
-    if (adjacentType < 0 || adjacentType >= game.blockCount) return 1;
-    
-    // Si le bloc adjacent est opaque, ne pas afficher
-    if(!game.blocks[adjacentType].transparent && !game.blocks[adjacentType].translucent) return 0;
-    
-    // Pour les blocs translucides : ne pas afficher les faces entre blocs identiques
-    if(game.blocks[currentType].translucent && adjacentType == currentType) {
-        return 0;
+    free(pos);
+    free(uv);
+    free(lists);
+    return realloc(baked, sizeof(BakedModel) + index * sizeof(ChunkVertex));
+}
+
+// Les 2 triangles de chaque face du cube forment un quad (cas de tout cube exporté par faces)
+// Condition du greedy meshing : un quad fusionné occupe alors toujours 4 sommets
+static int isCubeQuadMeshable(const OBPCubeGeometry *cube) {
+    for(int f = 0; f < 6; f++) {
+        float quadPos[4][3], quadUv[4][2];
+        if(!pairTriangles((const float (*)[3])cube->faces[f].corner, (const float (*)[2])cube->faces[f].uv,
+                          quadPos, quadUv)) return 0;
     }
-    
     return 1;
 }
 
-// Plus besoin de addCulledCube, les blocs statiques sont rendus par le modèle directement
+// Propriétés des blocs lues par le culling, résolues une fois par compileBlockModels
+#define MESH_FLAG_OPAQUE 1       // Cache les faces de ses voisins
+#define MESH_FLAG_TRANSLUCENT 2  // N'affiche pas ses faces contre un bloc identique
+#define MESH_FLAG_GREEDY 4       // Cube plein maillé par fusion de faces
+static uint8_t *blockMeshFlags = NULL;
+static int blockMeshFlagCount = 0;
 
-// Buffers partagés pour la génération de mesh (évite malloc/free à chaque chunk)
-// Taille max théorique : 16*16*16 blocs * 36 vertices * 6 floats
-#define MAX_CHUNK_FLOATS (CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z * 36 * 6)
-static float* sharedOpaqueVertices = NULL;
-static float* sharedTransparentVertices = NULL;
-static float* sharedFoliageVertices = NULL;
+// Type hors table = aucun drapeau (face affichée contre lui)
+static inline uint8_t meshFlags(BlockType type) {
+    return ((unsigned int)type < (unsigned int)blockMeshFlagCount) ? blockMeshFlags[type] : 0;
+}
 
-// Initialise les buffers partagés si nécessaire
-static void initSharedBuffers() {
-    if (sharedOpaqueVertices == NULL) {
-        sharedOpaqueVertices = malloc(MAX_CHUNK_FLOATS * sizeof(float));
-        sharedTransparentVertices = malloc(MAX_CHUNK_FLOATS * sizeof(float));
-        sharedFoliageVertices = malloc(MAX_CHUNK_FLOATS * sizeof(float));
+// Boîte englobante du modèle à BAKED_MODEL_MAX_EXTENT blocs de l'origine : l'ajout de l'offset
+// du bloc (au plus 15 blocs en X/Z, 255 en Y) ne déborde alors sur aucun champ voisin
+// Lue sur les positions avant compression, qu'un clamp de packSixteenths masquerait
+static int isBakedModelInRange(const BakedModel *model) {
+    for(int k = 0; k < 3; k++) {
+        if(model->boundsMin[k] < -BAKED_MODEL_MAX_EXTENT || model->boundsMax[k] > BAKED_MODEL_MAX_EXTENT) return 0;
     }
+    return 1;
 }
 
-// Reconstruit le mesh d'un chunk avec face culling
-// Sépare les blocs opaques, transparents (verre) et feuillage (fleurs) pour un rendu correct
-void rebuildChunkMesh(int cx, int cz) {
-    // printf("Rebuilding chunk %d, %d\n", cx, cz);
-    extern Chunk **world;
+void compileBlockModels() {
+    maxBakedModelVertices = 24;
+    free(blockMeshFlags);
+    blockMeshFlags = calloc(game.blockCount > 0 ? game.blockCount : 1, sizeof(uint8_t));
+    blockMeshFlagCount = game.blockCount;
     
-    initSharedBuffers();
+    for(int i = 1; i < game.blockCount; i++) {
+        BlockDefinition *def = &game.blocks[i];
+        free(def->bakedModel);
+        def->bakedModel = NULL;
+        
+        if(!def->transparent && !def->translucent) blockMeshFlags[i] |= MESH_FLAG_OPAQUE;
+        if(def->translucent) blockMeshFlags[i] |= MESH_FLAG_TRANSLUCENT;
+        if(!def->model) continue;
+        
+        // Les sommets compressés n'ont que 12 bits de couche : au-delà, la couche déborderait
+        // sur les autres champs. Le bloc garde ses collisions et son culling mais n'est pas maillé
+        if(def->textureLayer < 0 || def->textureLayer > CHUNK_VERTEX_MAX_LAYER) {
+            fprintf(stderr, "Attention: bloc '%s' : couche de texture %d hors des sommets de chunk (max %d), bloc non affiché\n",
+                    def->name, def->textureLayer, CHUNK_VERTEX_MAX_LAYER);
+            continue;
+        }
+        
+        def->bakedModel = bakeBlockModel(def->model, def->textureLayer);
+        if(!isBakedModelInRange(def->bakedModel)) {
+            fprintf(stderr, "Attention: bloc '%s' : modèle à plus de %d blocs de son origine, bloc non affiché\n",
+                    def->name, BAKED_MODEL_MAX_EXTENT);
+            free(def->bakedModel);
+            def->bakedModel = NULL;
+            continue;
+        }
+        int vertexCount = def->bakedModel->faceStart[BAKED_FACE_LISTS];
+        if(vertexCount > maxBakedModelVertices) maxBakedModelVertices = vertexCount;
+        
+        // Les blocs dynamiques et sans culling gardent le modèle bloc par bloc
+        if(!def->isDynamic && def->cullMode == CULL_MODE_FACES && def->model->cube &&
+           isCubeQuadMeshable(def->model->cube)) {
+            blockMeshFlags[i] |= MESH_FLAG_GREEDY;
+        }
+    }
+}
+
+void freeBlockModels() {
+    for(int i = 0; i < game.blockCount; i++) {
+        free(game.blocks[i].bakedModel);
+        game.blocks[i].bakedModel = NULL;
+    }
+    free(blockMeshFlags);
+    blockMeshFlags = NULL;
+    blockMeshFlagCount = 0;
+}
+
+// Ajoute les faces visibles d'un modèle précompilé : copie puis décalage à la position du bloc
+// (positions relatives au chunk, en 1/16 de bloc ; un simple ajout sur le mot compressé)
+static inline void addBakedModel(ChunkVertex *vertices, int *index, int x, int y, int z,
+                                 const BakedModel *model, uint8_t visibleMask) {
+    uint32_t offset = (uint32_t)(x * 16) | (uint32_t)(z * 16) << 9 | (uint32_t)(y * 16) << 18;
     
-    Chunk *chunk = &game.world[cx][cz];
+    for(int f = 0; f < BAKED_FACE_LISTS; f++) {
+        if(f != BAKED_FACE_ALWAYS && !((visibleMask >> f) & 1)) continue; // Face cachée
+        
+        int count = model->faceStart[f + 1] - model->faceStart[f];
+        if(count == 0) continue;
+        ChunkVertex *out = &vertices[*index];
+        memcpy(out, &model->vertices[model->faceStart[f]], count * sizeof(ChunkVertex));
+        for(int i = 0; i < count; i++) out[i].position += offset;
+        *index += count;
+    }
+}
+
+// Faces visibles d'une section : bit z de faces[dir][x][y] = face dir du bloc (x, y, z) affichée
+// (dir : 0=Z+, 1=Z-, 2=X-, 3=X+, 4=Y-, 5=Y+)
+typedef struct {
+    uint16_t faces[6][SECTION_SIZE][SECTION_SIZE];
+    uint16_t greedy[SECTION_SIZE][SECTION_SIZE];  // Cubes pleins, maillés par fusion de faces
+    uint16_t others[SECTION_SIZE][SECTION_SIZE];  // Autres blocs non-air (modèle ou TileEntity)
+} SectionMasks;
+
+// Culling de toute une section par masques de bits, sans branche par face :
+// une face est affichée si le voisin n'est pas opaque, sauf entre deux blocs translucides
+// identiques. Le snapshot est lu en lignes de 18 bits le long de Z (bordure comprise) :
+// les voisins en Z sont des décalages de la ligne, ceux en X et Y les lignes adjacentes
+static void buildSectionMasks(const SectionSnapshot *section, SectionMasks *masks) {
+    uint32_t opaque[SNAPSHOT_SIZE][SNAPSHOT_SIZE];
     
-    // Réinitialiser les TileEntities pour ce chunk
-    chunk->tileEntityCount = 0;
+    for(int x = 0; x < SNAPSHOT_SIZE; x++) {
+        for(int y = 0; y < SNAPSHOT_SIZE; y++) {
+            const BlockType *row = section->blocks[x][y];
+            uint32_t opaqueRow = 0;
+            for(int z = 0; z < SNAPSHOT_SIZE; z++) {
+                opaqueRow |= (uint32_t)(meshFlags(row[z]) & MESH_FLAG_OPAQUE) << z;
+            }
+            opaque[x][y] = opaqueRow;
+        }
+    }
     
-    int opaqueIndex = 0;
-    int transparentIndex = 0;
-    int foliageIndex = 0;
+    for(int x = 1; x <= SECTION_SIZE; x++) {
+        for(int y = 1; y <= SECTION_SIZE; y++) {
+            const BlockType *row = section->blocks[x][y];
+            uint32_t present = 0, greedy = 0, translucent = 0;
+            for(int z = 1; z <= SECTION_SIZE; z++) {
+                uint8_t flags = meshFlags(row[z]);
+                present |= (uint32_t)(row[z] != BLOCK_AIR) << z;
+                greedy |= (uint32_t)((flags & MESH_FLAG_GREEDY) != 0) << z;
+                translucent |= (uint32_t)((flags & MESH_FLAG_TRANSLUCENT) != 0) << z;
+            }
+            
+            uint32_t hidden[6] = {
+                opaque[x][y] >> 1, opaque[x][y] << 1,
+                opaque[x - 1][y], opaque[x + 1][y],
+                opaque[x][y - 1], opaque[x][y + 1]
+            };
+            
+            // Le dessous du monde est fermé, comme pour isSectionEnclosed : le mesh d'une
+            // section ne dépend ainsi que de ses blocs et de sa bordure
+            if(y == 1 && section->sectionY == 0) hidden[4] = ~0u;
+            
+            // Blocs translucides (verre, eau) : rares, comparés un par un à leurs voisins
+            while(translucent) {
+                int z = __builtin_ctz(translucent);
+                translucent &= translucent - 1;
+                BlockType type = row[z];
+                uint32_t bit = 1u << z;
+                if(row[z + 1] == type) hidden[0] |= bit;
+                if(row[z - 1] == type) hidden[1] |= bit;
+                if(section->blocks[x - 1][y][z] == type) hidden[2] |= bit;
+                if(section->blocks[x + 1][y][z] == type) hidden[3] |= bit;
+                if(section->blocks[x][y - 1][z] == type) hidden[4] |= bit;
+                if(section->blocks[x][y + 1][z] == type) hidden[5] |= bit;
+            }
+            
+            for(int dir = 0; dir < 6; dir++) {
+                masks->faces[dir][x - 1][y - 1] = (uint16_t)((present & ~hidden[dir]) >> 1);
+            }
+            masks->greedy[x - 1][y - 1] = (uint16_t)(greedy >> 1);
+            masks->others[x - 1][y - 1] = (uint16_t)((present & ~greedy) >> 1);
+        }
+    }
+}
+
+// Ajoute une face fusionnée de w x h blocs (w le long de l'axe A, h le long de B)
+// Les sommets du modèle sont étirés et l'UV déborde de [0,1] : GL_REPEAT répète la texture
+static inline void addGreedyQuad(ChunkVertex *vertices, int *index, const int blockPos[3], int faceDir,
+                                 int w, int h, const OBPCubeGeometry *cube, BlockType blockType) {
+    const OBPCubeFace *face = &cube->faces[faceDir];
+    int axisA = obpCubeFaceAxes[faceDir][1];
+    int axisB = obpCubeFaceAxes[faceDir][2];
+    float pos[6][3], uv[6][2];
     
-    // Parcourir tous les blocs du chunk
-    for(int x = 0; x < CHUNK_SIZE_X; x++) {
-        for(int y = 0; y < CHUNK_SIZE_Y; y++) {
-            for(int z = 0; z < CHUNK_SIZE_Z; z++) {
-                BlockType type = chunk->blocks[x][y][z].type;
-                
-                // Ignorer les blocs air
-                if(type == BLOCK_AIR) continue;
-                
-                // Vérifier si c'est un bloc spécial (TileEntity)
-                // On utilise le flag isDynamic défini dans blocks.block
-                if(game.blocks[type].isDynamic) {
-                    if(chunk->tileEntityCount >= chunk->tileEntityCapacity) {
-                        int newCap = (chunk->tileEntityCapacity == 0) ? 4 : chunk->tileEntityCapacity * 2;
-                        chunk->tileEntities = realloc(chunk->tileEntities, newCap * sizeof(TileEntity));
-                        chunk->tileEntityCapacity = newCap;
-                    }
+    for(int k = 0; k < 6; k++) {
+        float local[3] = { face->corner[k][0], face->corner[k][1], face->corner[k][2] };
+        float stretchA = local[axisA] * (w - 1);
+        float stretchB = local[axisB] * (h - 1);
+        local[axisA] *= w;
+        local[axisB] *= h;
+        
+        for(int a = 0; a < 3; a++) pos[k][a] = blockPos[a] + cube->origin[a] + local[a];
+        uv[k][0] = face->uv[k][0] + face->uvStepA[0] * stretchA + face->uvStepB[0] * stretchB;
+        uv[k][1] = face->uv[k][1] + face->uvStepA[1] * stretchA + face->uvStepB[1] * stretchB;
+    }
+    // Toujours un quad : vérifié par isCubeQuadMeshable avant d'activer le greedy meshing
+    addPackedTrianglePair(vertices, index, (const float (*)[3])pos, (const float (*)[2])uv,
+                          game.blocks[blockType].textureLayer);
+}
+
+// Greedy meshing des cubes pleins d'une section : pour chaque direction et chaque couche,
+// les faces visibles d'un même type sont fusionnées en rectangles aussi grands que possible
+static void addGreedySectionFaces(const SectionSnapshot *section, const SectionMasks *masks, int baseY,
+                                  MeshScratch *scratch, int layerIndex[RENDER_LAYER_COUNT]) {
+    BlockType mask[SECTION_SIZE][SECTION_SIZE];
+    
+    for(int faceDir = 0; faceDir < 6; faceDir++) {
+        int normalAxis = obpCubeFaceAxes[faceDir][0];
+        int axisA = obpCubeFaceAxes[faceDir][1];
+        int axisB = obpCubeFaceAxes[faceDir][2];
+        
+        for(int layer = 0; layer < SECTION_SIZE; layer++) {
+            // Masque des faces visibles de la couche (type du bloc, air si pas de face)
+            int pos[3];
+            pos[normalAxis] = layer;
+            for(int a = 0; a < SECTION_SIZE; a++) {
+                pos[axisA] = a;
+                for(int b = 0; b < SECTION_SIZE; b++) {
+                    pos[axisB] = b;
+                    uint16_t visible = masks->faces[faceDir][pos[0]][pos[1]] & masks->greedy[pos[0]][pos[1]];
+                    mask[a][b] = ((visible >> pos[2]) & 1) ? section->blocks[pos[0] + 1][pos[1] + 1][pos[2] + 1]
+                                                           : BLOCK_AIR;
+                }
+            }
+            
+            // Fusion : étendre le long de A, puis le long de B tant que la ligne entière correspond
+            for(int b = 0; b < SECTION_SIZE; b++) {
+                for(int a = 0; a < SECTION_SIZE; ) {
+                    BlockType type = mask[a][b];
+                    if(type == BLOCK_AIR) { a++; continue; }
                     
-                    TileEntity* te = &chunk->tileEntities[chunk->tileEntityCount++];
-                    te->x = x;
-                    te->y = y;
-                    te->z = z;
-                    te->type = type;
-                    te->animState = 0.0f; // Fermé par défaut
-                    te->rotation = 0;     // Nord par défaut
+                    int w = 1;
+                    while(a + w < SECTION_SIZE && mask[a + w][b] == type) w++;
                     
-                    // NE PAS ajouter au mesh statique !
-                    continue;
-                }
-                
-                // Bloc standard : utiliser le modèle pour le baking
-                
-                if(!game.blocks[type].model) {
-                    // Pas de modèle = on ignore (ne devrait pas arriver)
-                    continue;
-                }
-                
-                // Déterminer dans quel buffer ce bloc va
-                float* vertices;
-                int* index;
-                
-                if(game.blocks[type].translucent) {
-                    vertices = sharedTransparentVertices;
-                    index = &transparentIndex;
-                } else if(strcmp(game.blocks[type].name, "Flower") == 0) {
-                    vertices = sharedFoliageVertices;
-                    index = &foliageIndex;
-                } else {
-                    vertices = sharedOpaqueVertices;
-                    index = &opaqueIndex;
-                }
-                
-                // Bake le modèle dans le mesh du chunk (OBP)
-                if(game.blocks[type].model) {
-                    // Calculer le masque de visibilité des faces
-                    uint8_t visibleMask = 0;
+                    int h = 1;
+                    while(b + h < SECTION_SIZE) {
+                        int rowMatches = 1;
+                        for(int i = 0; i < w; i++) {
+                            if(mask[a + i][b + h] != type) { rowMatches = 0; break; }
+                        }
+                        if(!rowMatches) break;
+                        h++;
+                    }
                     
-                    // Pour les fleurs et feuillages, on affiche toujours tout (pas de culling)
-                    if (strcmp(game.blocks[type].name, "Flower") == 0) {
-                        visibleMask = 0xFF;
-                    } else {
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 0)) visibleMask |= (1 << 0); // Z+
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 1)) visibleMask |= (1 << 1); // Z-
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 2)) visibleMask |= (1 << 2); // X-
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 3)) visibleMask |= (1 << 3); // X+
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 4)) visibleMask |= (1 << 4); // Y-
-                        if (shouldRenderCubeFace(chunk, cx, cz, x, y, z, type, 5)) visibleMask |= (1 << 5); // Y+
+                    for(int j = 0; j < h; j++) {
+                        for(int i = 0; i < w; i++) mask[a + i][b + j] = BLOCK_AIR;
                     }
                     
-                    addOBPModel(vertices, index, x, y, z, game.blocks[type].model, type, visibleMask);
+                    int blockPos[3];
+                    blockPos[normalAxis] = layer;
+                    blockPos[axisA] = a;
+                    blockPos[axisB] = b;
+                    blockPos[1] += baseY;
+                    
+                    RenderLayer renderLayer = game.blocks[type].renderLayer;
+                    addGreedyQuad(scratch->vertices[renderLayer], &layerIndex[renderLayer], blockPos, faceDir, w, h,
+                                  game.blocks[type].model->cube, type);
+                    a += w;
                 }
             }
         }
     }
+}
+
+// Taille max du mesh d'une section : 16*16*16 blocs * le plus gros modèle (24 sommets pour un cube)
+#define MAX_SECTION_VERTICES (SECTION_VOLUME * maxBakedModelVertices)
+
+void initMeshScratch(MeshScratch *scratch) {
+    // Les pages ne sont réellement allouées par l'OS qu'au premier accès
+    for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+        scratch->vertices[layer] = malloc(MAX_SECTION_VERTICES * sizeof(ChunkVertex));
+        scratch->capacity[layer] = MAX_SECTION_VERTICES;
+    }
+}
+
+void freeMeshScratch(MeshScratch *scratch) {
+    for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+        free(scratch->vertices[layer]);
+    }
+    memset(scratch, 0, sizeof(MeshScratch));
+}
+
+// Garantit la place pour le mesh d'une section de plus après "used" sommets
+static void reserveScratch(ChunkVertex **vertices, int *capacity, int used) {
+    if(used + MAX_SECTION_VERTICES <= *capacity) return;
+    while(used + MAX_SECTION_VERTICES > *capacity) *capacity *= 2;
+    *vertices = realloc(*vertices, *capacity * sizeof(ChunkVertex));
+}
+
+// Section uniforme d'un bloc opaque : cache entièrement les faces qui la touchent
+static inline int isStorageSolidOpaque(const BlockStorage *storage) {
+    if(!isStorageUniform(storage)) return 0;
+    BlockType type = storage->palette[0];
+    if(type == BLOCK_AIR) return 0;
+    const BlockDefinition *def = &game.blocks[type];
+    return !def->transparent && !def->translucent && !def->isDynamic;
+}
+
+// Versions des sections lues une seule fois par copie : la copie reste cohérente
+// même si le thread principal publie de nouvelles versions pendant qu'elle se fait
+typedef struct {
+    const BlockStorage *own[CHUNK_SECTIONS];
+    const BlockStorage *neighbors[4][CHUNK_SECTIONS];  // X-, X+, Z-, Z+ ; NULL = voisin absent
+} SectionView;
+
+// Section pleine entourée de sections pleines sur ses 6 faces : aucune face visible
+// Le dessous du monde compte comme fermé ; le dessus et un voisin non chargé comme ouverts
+static int isSectionEnclosed(const SectionView *view, int s) {
+    if(!isStorageSolidOpaque(view->own[s])) return 0;
+    if(s + 1 >= CHUNK_SECTIONS || !isStorageSolidOpaque(view->own[s + 1])) return 0;
+    if(s > 0 && !isStorageSolidOpaque(view->own[s - 1])) return 0;
+    for(int i = 0; i < 4; i++) {
+        if(!view->neighbors[i][s] || !isStorageSolidOpaque(view->neighbors[i][s])) return 0;
+    }
+    return 1;
+}
+
+// Copie une section et sa bordure : 4 chunks voisins en X/Z, sections voisines en Y
+// Voisin non chargé ou hors monde = air (face affichée) ; les arêtes et coins ne sont jamais lus
+static void snapshotSection(const SectionView *view, int s, SectionSnapshot *out) {
+    memset(out->blocks, 0, sizeof(out->blocks));
+    out->sectionY = s;
     
-    // Calculer le nombre de vertices générés
-    chunk->vertexCount = opaqueIndex / 6;
-    chunk->transparentVertexCount = transparentIndex / 6;
-    chunk->foliageVertexCount = foliageIndex / 6;
-    
-    // === MESH OPAQUE ===
-    if(chunk->VAO == 0) {
-        glGenVertexArrays(1, &chunk->VAO);
-        glGenBuffers(1, &chunk->VBO);
+    // Intérieur : décompression en une passe puis copie par lignes Z
+    BlockType blocks[SECTION_VOLUME];
+    unpackStorage(view->own[s], blocks);
+    for(int x = 0; x < SECTION_SIZE; x++) {
+        for(int y = 0; y < SECTION_SIZE; y++) {
+            memcpy(&out->blocks[x + 1][y + 1][1], &blocks[storageIndex(x, y, 0)], SECTION_SIZE * sizeof(BlockType));
+        }
     }
     
-    glBindVertexArray(chunk->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, chunk->VBO);
-    glBufferData(GL_ARRAY_BUFFER, opaqueIndex * sizeof(float), sharedOpaqueVertices, GL_STATIC_DRAW);
+    // Couches du dessous et du dessus (même colonne)
+    const BlockStorage *below = (s > 0) ? view->own[s - 1] : NULL;
+    const BlockStorage *above = (s + 1 < CHUNK_SECTIONS) ? view->own[s + 1] : NULL;
+    for(int x = 0; x < SECTION_SIZE; x++) {
+        for(int z = 0; z < SECTION_SIZE; z++) {
+            if(below) out->blocks[x + 1][0][z + 1] = getStorageBlock(below, x, SECTION_SIZE - 1, z);
+            if(above) out->blocks[x + 1][SECTION_SIZE + 1][z + 1] = getStorageBlock(above, x, 0, z);
+        }
+    }
     
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // Faces latérales : neighbors = X-, X+, Z-, Z+
+    const BlockStorage *sides[4] = {
+        view->neighbors[0][s], view->neighbors[1][s], view->neighbors[2][s], view->neighbors[3][s]
+    };
+    for(int i = 0; i < SECTION_SIZE; i++) {
+        for(int y = 0; y < SECTION_SIZE; y++) {
+            if(sides[0]) out->blocks[0][y + 1][i + 1] = getStorageBlock(sides[0], SECTION_SIZE - 1, y, i);
+            if(sides[1]) out->blocks[SECTION_SIZE + 1][y + 1][i + 1] = getStorageBlock(sides[1], 0, y, i);
+            if(sides[2]) out->blocks[i + 1][y + 1][0] = getStorageBlock(sides[2], i, y, SECTION_SIZE - 1);
+            if(sides[3]) out->blocks[i + 1][y + 1][SECTION_SIZE + 1] = getStorageBlock(sides[3], i, y, 0);
+        }
+    }
+}
+
+// Voisin complet, NULL s'il est absent ou encore en génération (traité comme de l'air)
+static const Chunk* readyNeighbor(int cx, int cz) {
+    const Chunk *neighbor = chunkMapGet(game.world, cx, cz);
+    return (neighbor && neighbor->genStage == CHUNK_STAGE_READY) ? neighbor : NULL;
+}
+
+void getChunkNeighbors(const Chunk *chunk, const Chunk *neighbors[4]) {
+    neighbors[0] = readyNeighbor(chunk->cx - 1, chunk->cz);
+    neighbors[1] = readyNeighbor(chunk->cx + 1, chunk->cz);
+    neighbors[2] = readyNeighbor(chunk->cx, chunk->cz - 1);
+    neighbors[3] = readyNeighbor(chunk->cx, chunk->cz + 1);
+}
+
+void snapshotChunk(const Chunk *chunk, const Chunk *const neighbors[4], uint16_t sectionMask, ChunkSnapshot *snapshot) {
+    SectionView view;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        view.own[s] = chunkSection(chunk, s);
+        for(int i = 0; i < 4; i++) {
+            view.neighbors[i][s] = neighbors[i] ? chunkSection(neighbors[i], s) : NULL;
+        }
+    }
     
-    // === MESH TRANSPARENT ===
-    if(chunk->transparentVAO == 0) {
-        glGenVertexArrays(1, &chunk->transparentVAO);
-        glGenBuffers(1, &chunk->transparentVBO);
+    int meshed[CHUNK_SECTIONS];
+    int count = 0;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        if(!((sectionMask >> s) & 1)) continue;
+        if(isStorageEmpty(view.own[s]) || isSectionEnclosed(&view, s)) continue;
+        meshed[count++] = s;
     }
     
-    glBindVertexArray(chunk->transparentVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, chunk->transparentVBO);
-    glBufferData(GL_ARRAY_BUFFER, transparentIndex * sizeof(float), sharedTransparentVertices, GL_STATIC_DRAW);
+    snapshot->sectionMask = sectionMask;
+    snapshot->sectionCount = count;
+    snapshot->sections = (count > 0) ? malloc(count * sizeof(SectionSnapshot)) : NULL;
+    for(int i = 0; i < count; i++) {
+        snapshotSection(&view, meshed[i], &snapshot->sections[i]);
+    }
+}
+
+void freeChunkSnapshot(ChunkSnapshot *snapshot) {
+    free(snapshot->sections);
+    snapshot->sections = NULL;
+    snapshot->sectionCount = 0;
+    snapshot->sectionMask = 0;
+}
+
+// Copie la partie utilisée d'un buffer de travail dans un tableau à la taille exacte
+static ChunkVertex* copyVertices(const ChunkVertex *source, int vertexCount) {
+    if(vertexCount == 0) return NULL;
+    ChunkVertex *copy = malloc(vertexCount * sizeof(ChunkVertex));
+    memcpy(copy, source, vertexCount * sizeof(ChunkVertex));
+    return copy;
+}
+
+// Construit le mesh CPU des sections du snapshot (sans appel OpenGL)
+// Un mesh par section et par passe de rendu (opaque, végétation, translucide) déclarée
+// dans blocks.block ; les sections du masque sans copie ont un mesh vide
+// Thread-safe : n'écrit que dans scratch et out, lit game.blocks en lecture seule
+void buildChunkMesh(const ChunkSnapshot *snapshot, MeshScratch *scratch, ChunkMeshData *out) {
+    memset(out, 0, sizeof(ChunkMeshData));
+    out->sectionMask = snapshot->sectionMask;
+    int tileEntityCapacity = 0;
     
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // Sommets écrits dans chaque passe
+    int layerIndex[RENDER_LAYER_COUNT] = {0};
+    int nextSection = 0;
     
-    // === MESH FEUILLAGE (fleurs) ===
-    if(chunk->foliageVAO == 0) {
-        glGenVertexArrays(1, &chunk->foliageVAO);
-        glGenBuffers(1, &chunk->foliageVBO);
+    // Parcourir les blocs des sections à mailler (les autres n'ont aucune face visible)
+    for(int s = 0; s < snapshot->sectionCount; s++) {
+        const SectionSnapshot *section = &snapshot->sections[s];
+        int baseY = section->sectionY * SECTION_SIZE;
+        
+        // Les sections sautées depuis la précédente ont un mesh vide
+        for(; nextSection <= section->sectionY; nextSection++) {
+            for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+                out->sectionStart[layer][nextSection] = layerIndex[layer];
+            }
+        }
+        
+        for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+            reserveScratch(&scratch->vertices[layer], &scratch->capacity[layer], layerIndex[layer]);
+        }
+        
+        SectionMasks masks;
+        buildSectionMasks(section, &masks);
+        addGreedySectionFaces(section, &masks, baseY, scratch, layerIndex);
+        
+        // Blocs restants (ni air, ni cube plein) : parcours des bits de leurs masques
+        for(int x = 0; x < SECTION_SIZE; x++) {
+            for(int ly = 0; ly < SECTION_SIZE; ly++) {
+                uint32_t remaining = masks.others[x][ly];
+                while(remaining) {
+                    int z = __builtin_ctz(remaining);
+                    remaining &= remaining - 1;
+                    BlockType type = section->blocks[x + 1][ly + 1][z + 1];
+                    int y = baseY + ly;
+                    
+                    // Vérifier si c'est un bloc spécial (TileEntity)
+                    // On utilise le flag isDynamic défini dans blocks.block
+                    if(game.blocks[type].isDynamic) {
+                        if(out->tileEntityCount >= tileEntityCapacity) {
+                            tileEntityCapacity = (tileEntityCapacity == 0) ? 4 : tileEntityCapacity * 2;
+                            out->tileEntities = realloc(out->tileEntities, tileEntityCapacity * sizeof(TileEntity));
+                        }
+                    
+                        TileEntity* te = &out->tileEntities[out->tileEntityCount++];
+                        te->x = x;
+                        te->y = y;
+                        te->z = z;
+                        te->type = type;
+                        te->animState = 0.0f; // Fermé par défaut
+                        te->rotation = 0;     // Nord par défaut
+                    
+                        // NE PAS ajouter au mesh statique !
+                        continue;
+                    }
+                    
+                    // Bloc standard : utiliser le modèle précompilé
+                    const BlockDefinition *def = &game.blocks[type];
+                    if(!def->bakedModel) {
+                        // Pas de modèle = on ignore (ne devrait pas arriver)
+                        continue;
+                    }
+                    
+                    // Masque de visibilité des faces, toutes affichées sans culling (végétation)
+                    uint8_t visibleMask = 0xFF;
+                    if(def->cullMode == CULL_MODE_FACES) {
+                        visibleMask = 0;
+                        for(int dir = 0; dir < 6; dir++) {
+                            visibleMask |= ((masks.faces[dir][x][ly] >> z) & 1) << dir;
+                        }
+                    }
+                    
+                    // Copier les faces visibles du modèle précompilé
+                    addBakedModel(scratch->vertices[def->renderLayer], &layerIndex[def->renderLayer], x, y, z,
+                                  def->bakedModel, visibleMask);
+                }
+            }
+        }
     }
     
-    glBindVertexArray(chunk->foliageVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, chunk->foliageVBO);
-    glBufferData(GL_ARRAY_BUFFER, foliageIndex * sizeof(float), sharedFoliageVertices, GL_STATIC_DRAW);
+    for(; nextSection <= CHUNK_SECTIONS; nextSection++) {
+        for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+            out->sectionStart[layer][nextSection] = layerIndex[layer];
+        }
+    }
     
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // Copier les vertices générés hors des buffers de travail (réutilisés par le worker)
+    for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+        out->vertices[layer] = copyVertices(scratch->vertices[layer], layerIndex[layer]);
+    }
+}
+
+void freeChunkMeshData(ChunkMeshData *data) {
+    for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+        free(data->vertices[layer]);
+    }
+    free(data->tileEntities);
+    memset(data, 0, sizeof(ChunkMeshData));
+}
+
+// Envoie un mesh construit sur le GPU, dans l'arène de sommets partagée (thread de rendu uniquement)
+// Seules les sections reconstruites sont réuploadées, dans leurs pages si elles y tiennent
+// Leurs TileEntities remplacent celles du chunk (data en perd la propriété)
+void uploadChunkMesh(Chunk *chunk, ChunkMeshData *data) {
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        if(!((data->sectionMask >> s) & 1)) continue;
+        
+        // Un mesh par passe : opaque, végétation, translucide
+        for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+            int start = data->sectionStart[layer][s];
+            int count = data->sectionStart[layer][s + 1] - start;
+            uploadMeshRange(&chunk->mesh[s][layer], data->vertices[layer] + start, count, chunk->cx, chunk->cz);
+        }
+    }
     
-    chunk->needsRebuild = 0;
+    // Garder les TileEntities des sections non reconstruites, puis ajouter les nouvelles
+    int kept = 0;
+    for(int i = 0; i < chunk->tileEntityCount; i++) {
+        if((data->sectionMask >> (chunk->tileEntities[i].y / SECTION_SIZE)) & 1) continue;
+        chunk->tileEntities[kept++] = chunk->tileEntities[i];
+    }
+    chunk->tileEntityCount = kept;
     
-    // printf("Chunk (%d, %d) mesh rebuilt: %d opaque + %d transparent + %d foliage vertices\n", 
-    //        cx, cz, chunk->vertexCount, chunk->transparentVertexCount, chunk->foliageVertexCount);
+    if(kept == 0) {
+        free(chunk->tileEntities);
+        chunk->tileEntities = data->tileEntities;
+        chunk->tileEntityCount = data->tileEntityCount;
+        chunk->tileEntityCapacity = data->tileEntityCount;
+        data->tileEntities = NULL;
+    } else if(data->tileEntityCount > 0) {
+        int needed = kept + data->tileEntityCount;
+        if(needed > chunk->tileEntityCapacity) {
+            chunk->tileEntityCapacity = needed;
+            chunk->tileEntities = realloc(chunk->tileEntities, needed * sizeof(TileEntity));
+        }
+        memcpy(&chunk->tileEntities[kept], data->tileEntities, data->tileEntityCount * sizeof(TileEntity));
+        chunk->tileEntityCount = needed;
+    }
+    data->tileEntityCount = 0;
 }
 
 void freeChunkMesh(Chunk *chunk) {
-    if(chunk->VAO != 0) {
-        glDeleteVertexArrays(1, &chunk->VAO);
-        glDeleteBuffers(1, &chunk->VBO);
-        chunk->VAO = 0;
-        chunk->VBO = 0;
-    }
-    if(chunk->transparentVAO != 0) {
-        glDeleteVertexArrays(1, &chunk->transparentVAO);
-        glDeleteBuffers(1, &chunk->transparentVBO);
-        chunk->transparentVAO = 0;
-        chunk->transparentVBO = 0;
-    }
-    if(chunk->foliageVAO != 0) {
-        glDeleteVertexArrays(1, &chunk->foliageVAO);
-        glDeleteBuffers(1, &chunk->foliageVBO);
-        chunk->foliageVAO = 0;
-        chunk->foliageVBO = 0;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+            releaseMeshRange(&chunk->mesh[s][layer]);
+        }
     }
 }
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "chunkmap.h"
+#include "blockstorage.h"
+
+// Nombre de chunks alloués d'un coup par le pool
+#define CHUNK_SLAB_SIZE 64
+
+static inline unsigned hashChunkCoords(int cx, int cz) {
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cz * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+ChunkMap* createChunkMap(int initialCapacity) {
+    ChunkMap* map = calloc(1, sizeof(ChunkMap));
+
+    int capacity = 16;
+    while(capacity < initialCapacity) capacity <<= 1;
+    map->capacity = capacity;
+    map->slots = calloc(capacity, sizeof(Chunk*));
+
+    pthread_mutex_init(&map->lock, NULL);
+    pthread_mutex_init(&map->poolLock, NULL);
+    return map;
+}
+
+void destroyChunkMap(ChunkMap* map) {
+    if(!map) return;
+    for(int i = 0; i < map->slabCount; i++) {
+        free(map->slabs[i]);
+    }
+    free(map->slabs);
+    free(map->slots);
+    pthread_mutex_destroy(&map->lock);
+    pthread_mutex_destroy(&map->poolLock);
+    free(map);
+}
+
+Chunk* chunkMapGet(ChunkMap* map, int cx, int cz) {
+    unsigned mask = map->capacity - 1;
+    unsigned i = hashChunkCoords(cx, cz) & mask;
+
+    while(map->slots[i]) {
+        Chunk* chunk = map->slots[i];
+        if(chunk->cx == cx && chunk->cz == cz) return chunk;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+// Insertion sans verrou ni redimensionnement (la place est garantie par l'appelant)
+static void insertSlot(Chunk** slots, int capacity, Chunk* chunk) {
+    unsigned mask = capacity - 1;
+    unsigned i = hashChunkCoords(chunk->cx, chunk->cz) & mask;
+    while(slots[i]) i = (i + 1) & mask;
+    slots[i] = chunk;
+}
+
+void chunkMapInsert(ChunkMap* map, Chunk* chunk) {
+    pthread_mutex_lock(&map->lock);
+
+    // Garder un facteur de charge <= 0.5 pour des sondages courts
+    if((map->count + 1) * 2 > map->capacity) {
+        int newCapacity = map->capacity * 2;
+        Chunk** newSlots = calloc(newCapacity, sizeof(Chunk*));
+        for(int i = 0; i < map->capacity; i++) {
+            if(map->slots[i]) insertSlot(newSlots, newCapacity, map->slots[i]);
+        }
+        free(map->slots);
+        map->slots = newSlots;
+        map->capacity = newCapacity;
+    }
+
+    insertSlot(map->slots, map->capacity, chunk);
+    map->count++;
+
+    pthread_mutex_unlock(&map->lock);
+}
+
+void chunkMapRemove(ChunkMap* map, Chunk* chunk) {
+    pthread_mutex_lock(&map->lock);
+
+    unsigned mask = map->capacity - 1;
+    unsigned i = hashChunkCoords(chunk->cx, chunk->cz) & mask;
+    while(map->slots[i] && map->slots[i] != chunk) i = (i + 1) & mask;
+
+    if(map->slots[i]) {
+        // Suppression par décalage arrière : pas de tombstones
+        map->slots[i] = NULL;
+        map->count--;
+        unsigned j = (i + 1) & mask;
+        while(map->slots[j]) {
+            Chunk* moved = map->slots[j];
+            unsigned home = hashChunkCoords(moved->cx, moved->cz) & mask;
+            // Déplacer si la position idéale n'est pas dans l'intervalle cyclique ]i, j]
+            int shouldMove = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+            if(shouldMove) {
+                map->slots[i] = moved;
+                map->slots[j] = NULL;
+                i = j;
+            }
+            j = (j + 1) & mask;
+        }
+    }
+
+    pthread_mutex_unlock(&map->lock);
+}
+
+Chunk* allocChunk(ChunkMap* map) {
+    pthread_mutex_lock(&map->poolLock);
+
+    if(!map->freeChunks) {
+        Chunk* slab = malloc(CHUNK_SLAB_SIZE * sizeof(Chunk));
+        map->slabs = realloc(map->slabs, (map->slabCount + 1) * sizeof(Chunk*));
+        map->slabs[map->slabCount++] = slab;
+        for(int i = CHUNK_SLAB_SIZE - 1; i >= 0; i--) {
+            slab[i].nextFree = map->freeChunks;
+            map->freeChunks = &slab[i];
+        }
+    }
+
+    Chunk* chunk = map->freeChunks;
+    map->freeChunks = chunk->nextFree;
+
+    pthread_mutex_unlock(&map->poolLock);
+
+    memset(chunk, 0, sizeof(Chunk));
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        atomic_init(&chunk->sections[s], createStorage(BLOCK_AIR));
+    }
+    chunk->dirtySections = CHUNK_ALL_SECTIONS;
+    return chunk;
+}
+
+// Les ressources GL (freeChunkMesh) doivent avoir été libérées avant
+void releaseChunk(ChunkMap* map, Chunk* chunk) {
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        destroyStorage(privateChunkSection(chunk, s));
+    }
+    free(chunk->tileEntities);
+    chunk->tileEntities = NULL;
+
+    pthread_mutex_lock(&map->poolLock);
+    chunk->nextFree = map->freeChunks;
+    map->freeChunks = chunk;
+    pthread_mutex_unlock(&map->poolLock);
+}
+
+void retireChunk(ChunkMap* map, Chunk* chunk) {
+    pthread_mutex_lock(&map->poolLock);
+    chunk->nextFree = map->retiredChunks;
+    map->retiredChunks = chunk;
+    pthread_mutex_unlock(&map->poolLock);
+}
+
+Chunk* takeRetiredChunks(ChunkMap* map) {
+    pthread_mutex_lock(&map->poolLock);
+    Chunk* list = map->retiredChunks;
+    map->retiredChunks = NULL;
+    pthread_mutex_unlock(&map->poolLock);
+    return list;
+}
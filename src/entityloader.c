@@ -6,6 +6,7 @@
 #include "world.h"
 #include "obp_loader.h"
 #include "entities.h"
+#include "blockregistry.h"
 
 // Map string to function
 static EntityRenderFunc getRendererByName(const char* name) {
@@ -0,0 +1,75 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "epoch.h"
+
+// Objet retiré à l'époque "epoch" : aucun lecteur entré après cette époque ne peut le voir
+typedef struct {
+    void* object;
+    void (*release)(void*);
+    uint64_t epoch;
+} RetiredObject;
+
+// Époque globale, avancée par epochReclaim (commence à 1 : 0 marque un lecteur inactif)
+static _Atomic uint64_t globalEpoch = 1;
+
+// Époque lue par chaque lecteur en entrant, 0 hors section de lecture (indexée par jobThreadSlot)
+static _Atomic uint64_t readerEpochs[EPOCH_MAX_READERS];
+static _Thread_local int readerSlot = -1;
+
+// Thread principal uniquement
+static RetiredObject* retired = NULL;
+static int retiredCount = 0;
+static int retiredCapacity = 0;
+
+void epochEnter() {
+    if(readerSlot < 0) readerSlot = jobThreadSlot();
+    atomic_store(&readerEpochs[readerSlot], atomic_load(&globalEpoch));
+    // L'annonce doit précéder toute lecture d'un pointeur publié (voir epochReclaim)
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void epochExit() {
+    atomic_store_explicit(&readerEpochs[readerSlot], 0, memory_order_release);
+}
+
+void epochRetire(void* object, void (*release)(void*)) {
+    if(retiredCount >= retiredCapacity) {
+        retiredCapacity = (retiredCapacity == 0) ? 256 : retiredCapacity * 2;
+        retired = realloc(retired, retiredCapacity * sizeof(RetiredObject));
+    }
+    retired[retiredCount].object = object;
+    retired[retiredCount].release = release;
+    retired[retiredCount].epoch = atomic_load(&globalEpoch);
+    retiredCount++;
+}
+
+void epochReclaim() {
+    // Les objets ont été dépubliés avant : un lecteur invisible ici ne peut plus les atteindre
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t current = atomic_load(&globalEpoch);
+    uint64_t oldest = current;
+    for(int i = 0; i < EPOCH_MAX_READERS; i++) {
+        uint64_t epoch = atomic_load(&readerEpochs[i]);
+        if(epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+
+    // Retiré avant l'entrée du plus ancien lecteur actif : plus aucune référence possible
+    int kept = 0;
+    for(int i = 0; i < retiredCount; i++) {
+        if(retired[i].epoch < oldest) retired[i].release(retired[i].object);
+        else retired[kept++] = retired[i];
+    }
+    retiredCount = kept;
+
+    atomic_store(&globalEpoch, current + 1);
+}
+
+void epochReclaimAll() {
+    for(int i = 0; i < retiredCount; i++) {
+        retired[i].release(retired[i].object);
+    }
+    free(retired);
+    retired = NULL;
+    retiredCount = retiredCapacity = 0;
+}
@@ -0,0 +1,136 @@
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "genworker.h"
+#include "worldgen.h"
+#include "chunkmap.h"
+#include "blockstorage.h"
+#include "jobsystem.h"
+
+// Un job = les blocs d'un chunk, générés hors du chunk puis installés par le thread principal
+typedef struct GenJob {
+    int cx, cz;
+    int ticket;
+    int seed;
+    BlockStorage sections[CHUNK_SECTIONS];
+    ChunkColumns columns;
+    struct GenJob* next;
+} GenJob;
+
+// File FIFO simple (liste chaînée)
+typedef struct {
+    GenJob* head;
+    GenJob* tail;
+} GenJobQueue;
+
+// Jobs terminés par les workers, récupérés par le thread principal
+static pthread_mutex_t doneMutex = PTHREAD_MUTEX_INITIALIZER;
+static GenJobQueue finishedJobs = {NULL, NULL};
+
+// Thread principal uniquement
+static int lastJobTicket = 0;
+static int jobsInFlight = 0;
+
+static void pushJob(GenJobQueue* queue, GenJob* job) {
+    job->next = NULL;
+    if(queue->tail) queue->tail->next = job;
+    else queue->head = job;
+    queue->tail = job;
+}
+
+static GenJob* popJob(GenJobQueue* queue) {
+    GenJob* job = queue->head;
+    if(job) {
+        queue->head = job->next;
+        if(!queue->head) queue->tail = NULL;
+    }
+    return job;
+}
+
+static void freeJob(GenJob* job) {
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        freeStorage(&job->sections[s]);
+    }
+    free(job);
+}
+
+static void freeJobQueue(GenJobQueue* queue) {
+    GenJob* job;
+    while((job = popJob(queue)) != NULL) {
+        freeJob(job);
+    }
+}
+
+// Job du système de jobs : génère les blocs du chunk hors du chunk
+static void generateChunkJob(void* data) {
+    GenJob* job = data;
+    generateChunk(job->cx, job->cz, job->seed, job->sections, &job->columns);
+
+    pthread_mutex_lock(&doneMutex);
+    pushJob(&finishedJobs, job);
+    pthread_mutex_unlock(&doneMutex);
+}
+
+void freeGenJobs() {
+    freeJobQueue(&finishedJobs);
+    jobsInFlight = 0;
+}
+
+void submitChunkGeneration(Chunk* chunk) {
+    GenJob* job = malloc(sizeof(GenJob));
+    job->cx = chunk->cx;
+    job->cz = chunk->cz;
+    job->seed = game.worldSeed;
+    if(++lastJobTicket <= 0) lastJobTicket = 1;
+    job->ticket = lastJobTicket;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        initStorage(&job->sections[s], BLOCK_AIR);
+    }
+
+    chunk->genStage = CHUNK_STAGE_GENERATING;
+    chunk->genJobTicket = job->ticket;
+    jobsInFlight++;
+
+    // Les chunks les plus proches sont soumis en premier : la file globale garde cet ordre
+    submitJob(generateChunkJob, job, NULL);
+}
+
+int collectGeneratedChunks(void (*onChunkGenerated)(Chunk* chunk)) {
+    pthread_mutex_lock(&doneMutex);
+    GenJobQueue done = finishedJobs;
+    finishedJobs.head = finishedJobs.tail = NULL;
+    pthread_mutex_unlock(&doneMutex);
+
+    int collected = 0;
+    GenJob* job;
+    while((job = popJob(&done)) != NULL) {
+        jobsInFlight--;
+
+        // Le chunk a pu être déchargé (voire rechargé) pendant la génération
+        Chunk* chunk = chunkMapGet(game.world, job->cx, job->cz);
+        if(!chunk || chunk->genStage != CHUNK_STAGE_GENERATING || chunk->genJobTicket != job->ticket) {
+            freeJob(job);
+            continue;
+        }
+
+        // Le chunk n'est pas encore visible du rendu : échange direct des sections
+        for(int s = 0; s < CHUNK_SECTIONS; s++) {
+            BlockStorage* section = privateChunkSection(chunk, s);
+            freeStorage(section);
+            *section = job->sections[s];
+        }
+        chunk->columns = job->columns;
+        free(job);
+
+        onChunkGenerated(chunk);
+        collected++;
+    }
+
+    return collected;
+}
+
+int pendingGenerationCount() {
+    return jobsInFlight;
+}
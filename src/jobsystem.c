@@ -0,0 +1,326 @@
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "jobsystem.h"
+
+// Capacité de la file de chaque worker (puissance de 2) ; au-delà, la file globale prend le relais
+#define JOB_DEQUE_CAPACITY 4096
+
+typedef struct Job {
+    JobFunc func;
+    void* data;
+    JobCounter* counter;
+    struct Job* next;          // File globale ou liste d'attente d'un compteur
+} Job;
+
+// File à vol de travail (Chase-Lev) : le propriétaire pousse et reprend par le bas,
+// les autres volent par le haut ; seule la course sur le dernier job passe par un CAS
+typedef struct {
+    atomic_long top;
+    atomic_long bottom;
+    _Atomic(Job*) slots[JOB_DEQUE_CAPACITY];
+} JobDeque;
+
+static pthread_t* workers = NULL;
+static JobDeque* deques = NULL;
+static int workerCount = 0;
+static atomic_int shouldExit = 0;
+
+// File globale : jobs soumis hors des workers, ou d'un worker dont la file est pleine
+static pthread_mutex_t globalMutex = PTHREAD_MUTEX_INITIALIZER;
+static Job* globalHead = NULL;
+static Job* globalTail = NULL;
+static atomic_int globalCount = 0;
+
+// Jobs prêts pas encore démarrés (toutes files) ; les workers dorment quand il n'y en a plus
+static atomic_int queuedJobs = 0;
+static atomic_int sleepingWorkers = 0;
+static pthread_mutex_t sleepMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sleepCond = PTHREAD_COND_INITIALIZER;
+
+// Protège les listes d'attente des compteurs et leur passage à 0
+static pthread_mutex_t dependencyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Jamais réinitialisé : un emplacement hors workers n'est attribué qu'une fois
+static atomic_int threadSlotCount = JOB_MAX_WORKERS;
+static _Thread_local int threadSlot = -1;
+
+// Propriétaire uniquement ; 0 si la file est pleine
+static int dequePush(JobDeque* deque, Job* job) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if(bottom - top >= JOB_DEQUE_CAPACITY) return 0;
+    atomic_store_explicit(&deque->slots[bottom & (JOB_DEQUE_CAPACITY - 1)], job, memory_order_relaxed);
+    // Release : le job est visible des voleurs avant le nouveau bas
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return 1;
+}
+
+// Propriétaire uniquement : dernier job poussé
+static Job* dequeTake(JobDeque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    // Réserver le bas avant de lire le haut (ordre total avec le CAS des voleurs)
+    atomic_store(&deque->bottom, bottom);
+    long top = atomic_load(&deque->top);
+    if(top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    Job* job = atomic_load_explicit(&deque->slots[bottom & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if(top == bottom) {
+        // Dernier job : un voleur a pu le prendre entre-temps
+        if(!atomic_compare_exchange_strong(&deque->top, &top, top + 1)) job = NULL;
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+// N'importe quel thread : plus ancien job de la file, NULL si vide ou perdu face à un autre thread
+static Job* dequeSteal(JobDeque* deque) {
+    long top = atomic_load(&deque->top);
+    long bottom = atomic_load(&deque->bottom);
+    if(top >= bottom) return NULL;
+
+    Job* job = atomic_load_explicit(&deque->slots[top & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if(!atomic_compare_exchange_strong(&deque->top, &top, top + 1)) return NULL;
+    return job;
+}
+
+static void pushGlobalJob(Job* job) {
+    job->next = NULL;
+    pthread_mutex_lock(&globalMutex);
+    if(globalTail) globalTail->next = job;
+    else globalHead = job;
+    globalTail = job;
+    atomic_fetch_add(&globalCount, 1);
+    pthread_mutex_unlock(&globalMutex);
+}
+
+static Job* popGlobalJob() {
+    if(atomic_load_explicit(&globalCount, memory_order_relaxed) == 0) return NULL;
+
+    pthread_mutex_lock(&globalMutex);
+    Job* job = globalHead;
+    if(job) {
+        globalHead = job->next;
+        if(!globalHead) globalTail = NULL;
+        atomic_fetch_sub(&globalCount, 1);
+    }
+    pthread_mutex_unlock(&globalMutex);
+    return job;
+}
+
+// Met un job prêt en file (celle du worker appelant si possible) et réveille un worker
+static void pushReadyJob(Job* job) {
+    // Compté avant d'être publié : findJob peut le prendre dès le push, son décrément ne doit
+    // jamais passer avant (queuedJobs négatif, workers qui tournent au lieu de dormir)
+    // Un worker qui s'endort annonce son sommeil avant de relire queuedJobs : l'un des deux
+    // voit toujours l'autre, aucun réveil n'est perdu
+    atomic_fetch_add(&queuedJobs, 1);
+    int slot = jobThreadSlot();
+    if(slot >= workerCount || !dequePush(&deques[slot], job)) pushGlobalJob(job);
+
+    if(atomic_load(&sleepingWorkers) > 0) {
+        pthread_mutex_lock(&sleepMutex);
+        pthread_cond_signal(&sleepCond);
+        pthread_mutex_unlock(&sleepMutex);
+    }
+}
+
+// Prochain job pour le thread de l'emplacement slot : le sien, puis la file globale, puis un vol
+static Job* findJob(int slot) {
+    Job* job = NULL;
+    if(slot < workerCount) job = dequeTake(&deques[slot]);
+    if(!job) job = popGlobalJob();
+    for(int i = 1; !job && i <= workerCount; i++) {
+        int victim = (slot + i) % workerCount;
+        if(victim != slot) job = dequeSteal(&deques[victim]);
+    }
+
+    if(job) atomic_fetch_sub(&queuedJobs, 1);
+    return job;
+}
+
+static void finishJob(JobCounter* counter) {
+    // Le verrou couvre le passage à 0 : waitForJobs ne rend pas la main (et le compteur,
+    // souvent sur sa pile) tant que les jobs en attente n'ont pas été détachés
+    pthread_mutex_lock(&dependencyMutex);
+    Job* released = NULL;
+    if(atomic_fetch_sub(&counter->pending, 1) == 1) {
+        released = counter->waiters;
+        counter->waiters = NULL;
+    }
+    pthread_mutex_unlock(&dependencyMutex);
+
+    while(released) {
+        Job* next = released->next;
+        pushReadyJob(released);
+        released = next;
+    }
+}
+
+static void runJob(Job* job) {
+    job->func(job->data);
+    JobCounter* counter = job->counter;
+    free(job);
+    if(counter) finishJob(counter);
+}
+
+static void* workerFunc(void* arg) {
+    threadSlot = (int)(intptr_t)arg;
+
+    while(1) {
+        Job* job = findJob(threadSlot);
+        if(job) {
+            runJob(job);
+            continue;
+        }
+
+        // Arrêt seulement une fois toutes les files vidées
+        if(atomic_load(&shouldExit) && atomic_load(&queuedJobs) == 0) break;
+
+        pthread_mutex_lock(&sleepMutex);
+        atomic_fetch_add(&sleepingWorkers, 1);
+        while(atomic_load(&queuedJobs) == 0 && !atomic_load(&shouldExit)) {
+            pthread_cond_wait(&sleepCond, &sleepMutex);
+        }
+        atomic_fetch_sub(&sleepingWorkers, 1);
+        pthread_mutex_unlock(&sleepMutex);
+    }
+
+    return NULL;
+}
+
+void initJobSystem() {
+    // Garder un coeur pour le thread principal et un pour le thread de rendu
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    workerCount = (cores > 2) ? (int)(cores - 2) : 1;
+    if(workerCount > JOB_MAX_WORKERS) workerCount = JOB_MAX_WORKERS;
+
+    atomic_store(&shouldExit, 0);
+    deques = calloc(workerCount, sizeof(JobDeque));
+    workers = malloc(workerCount * sizeof(pthread_t));
+    for(int i = 0; i < workerCount; i++) {
+        if(pthread_create(&workers[i], NULL, workerFunc, (void*)(intptr_t)i) != 0) {
+            fprintf(stderr, "Erreur: impossible de créer le worker %d\n", i);
+            exit(1);
+        }
+    }
+
+    printf("[JobSystem] %d workers démarrés\n", workerCount);
+}
+
+void stopJobSystem() {
+    pthread_mutex_lock(&sleepMutex);
+    atomic_store(&shouldExit, 1);
+    pthread_cond_broadcast(&sleepCond);
+    pthread_mutex_unlock(&sleepMutex);
+
+    for(int i = 0; i < workerCount; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    free(deques);
+    workers = NULL;
+    deques = NULL;
+    workerCount = 0;
+
+    printf("[JobSystem] Workers arrêtés\n");
+}
+
+int jobWorkerCount() {
+    return workerCount;
+}
+
+int jobThreadSlot() {
+    if(threadSlot < 0) {
+        threadSlot = atomic_fetch_add(&threadSlotCount, 1);
+        if(threadSlot >= JOB_MAX_THREADS) {
+            fprintf(stderr, "Erreur: plus de %d threads hors workers utilisent le système de jobs\n",
+                    JOB_MAX_THREADS - JOB_MAX_WORKERS);
+            exit(1);
+        }
+    }
+    return threadSlot;
+}
+
+void submitJob(JobFunc func, void* data, JobCounter* counter) {
+    Job* job = malloc(sizeof(Job));
+    job->func = func;
+    job->data = data;
+    job->counter = counter;
+    if(counter) atomic_fetch_add(&counter->pending, 1);
+    pushReadyJob(job);
+}
+
+void submitJobAfter(JobCounter* dependency, JobFunc func, void* data, JobCounter* counter) {
+    pthread_mutex_lock(&dependencyMutex);
+    if(atomic_load(&dependency->pending) == 0) {
+        pthread_mutex_unlock(&dependencyMutex);
+        submitJob(func, data, counter);
+        return;
+    }
+
+    Job* job = malloc(sizeof(Job));
+    job->func = func;
+    job->data = data;
+    job->counter = counter;
+    if(counter) atomic_fetch_add(&counter->pending, 1);
+    job->next = dependency->waiters;
+    dependency->waiters = job;
+    pthread_mutex_unlock(&dependencyMutex);
+}
+
+void waitForJobs(JobCounter* counter) {
+    int slot = jobThreadSlot();
+    while(atomic_load(&counter->pending) > 0) {
+        Job* job = findJob(slot);
+        if(job) runJob(job);
+        else sched_yield();
+    }
+
+    // Attendre que le dernier finishJob ait relâché le compteur
+    pthread_mutex_lock(&dependencyMutex);
+    pthread_mutex_unlock(&dependencyMutex);
+}
+
+// Tranche d'un parallelFor
+typedef struct {
+    void (*func)(int begin, int end, void* data);
+    void* data;
+    int begin, end;
+} ParallelRange;
+
+static void runParallelRange(void* arg) {
+    ParallelRange* range = arg;
+    range->func(range->begin, range->end, range->data);
+}
+
+void parallelFor(int count, int grain, void (*func)(int begin, int end, void* data), void* data) {
+    if(count <= 0) return;
+    if(grain < 1) grain = 1;
+    int rangeCount = (count + grain - 1) / grain;
+    if(rangeCount == 1 || workerCount == 0) {
+        func(0, count, data);
+        return;
+    }
+
+    ParallelRange* ranges = malloc(rangeCount * sizeof(ParallelRange));
+    JobCounter counter = JOB_COUNTER_INIT;
+    for(int r = 0; r < rangeCount; r++) {
+        ranges[r].func = func;
+        ranges[r].data = data;
+        ranges[r].begin = r * grain;
+        ranges[r].end = (r + 1) * grain < count ? (r + 1) * grain : count;
+        submitJob(runParallelRange, &ranges[r], &counter);
+    }
+
+    // Le thread appelant exécute des tranches lui aussi
+    waitForJobs(&counter);
+    free(ranges);
+}
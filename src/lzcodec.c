@@ -0,0 +1,125 @@
+#include <string.h>
+#include "lzcodec.h"
+
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline unsigned hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Longueur au-delà de 15 : suite d'octets 255 terminée par le reste
+static inline size_t writeLength(uint8_t* dst, size_t op, size_t length) {
+    while(length >= 255) {
+        dst[op++] = 255;
+        length -= 255;
+    }
+    dst[op++] = (uint8_t)length;
+    return op;
+}
+
+static size_t writeSequence(uint8_t* dst, size_t op, const uint8_t* literals, size_t literalCount,
+                            size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - LZ_MIN_MATCH : 0;
+    uint8_t token = (uint8_t)(((literalCount < 15) ? literalCount : 15) << 4);
+    token |= (uint8_t)((matchCode < 15) ? matchCode : 15);
+    dst[op++] = token;
+
+    if(literalCount >= 15) op = writeLength(dst, op, literalCount - 15);
+    memcpy(dst + op, literals, literalCount);
+    op += literalCount;
+
+    // Dernière séquence : littéraux seuls
+    if(matchLength == 0) return op;
+
+    dst[op++] = (uint8_t)(offset & 0xFF);
+    dst[op++] = (uint8_t)(offset >> 8);
+    if(matchCode >= 15) op = writeLength(dst, op, matchCode - 15);
+    return op;
+}
+
+size_t lzCompress(const uint8_t* src, size_t srcSize, uint8_t* dst) {
+    // Dernière position vue pour chaque empreinte de 4 octets (+1, 0 = aucune)
+    uint32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+
+    size_t ip = 0, anchor = 0, op = 0;
+    while(ip + LZ_MIN_MATCH <= srcSize) {
+        uint32_t sequence = read32(src + ip);
+        unsigned h = hashSequence(sequence);
+        size_t candidate = table[h];
+        table[h] = (uint32_t)(ip + 1);
+
+        if(candidate == 0 || ip - (candidate - 1) > LZ_MAX_OFFSET || read32(src + candidate - 1) != sequence) {
+            ip++;
+            continue;
+        }
+
+        size_t ref = candidate - 1;
+        size_t length = LZ_MIN_MATCH;
+        while(ip + length < srcSize && src[ref + length] == src[ip + length]) length++;
+
+        op = writeSequence(dst, op, src + anchor, ip - anchor, ip - ref, length);
+        ip += length;
+        anchor = ip;
+    }
+
+    return writeSequence(dst, op, src + anchor, srcSize - anchor, 0, 0);
+}
+
+// Lit une longueur étendue ; retourne -1 si l'entrée est tronquée
+static inline int readLength(const uint8_t* src, size_t srcSize, size_t* ip, size_t* length) {
+    uint8_t byte;
+    do {
+        if(*ip >= srcSize) return -1;
+        byte = src[(*ip)++];
+        *length += byte;
+    } while(byte == 255);
+    return 0;
+}
+
+int lzDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t ip = 0, op = 0;
+
+    while(ip < srcSize) {
+        uint8_t token = src[ip++];
+
+        size_t literalCount = token >> 4;
+        if(literalCount == 15 && readLength(src, srcSize, &ip, &literalCount) < 0) return -1;
+        if(literalCount > srcSize - ip || literalCount > dstSize - op) return -1;
+        memcpy(dst + op, src + ip, literalCount);
+        ip += literalCount;
+        op += literalCount;
+
+        // Fin du flux après les littéraux de la dernière séquence
+        if(ip == srcSize) break;
+
+        if(srcSize - ip < 2) return -1;
+        size_t offset = src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > op) return -1;
+
+        size_t matchLength = token & 0x0F;
+        if(matchLength == 15 && readLength(src, srcSize, &ip, &matchLength) < 0) return -1;
+        matchLength += LZ_MIN_MATCH;
+        if(matchLength > dstSize - op) return -1;
+
+        // Les correspondances peuvent se chevaucher (répétitions) : copie octet par octet
+        const uint8_t* match = dst + op - offset;
+        if(offset >= matchLength) {
+            memcpy(dst + op, match, matchLength);
+        } else {
+            for(size_t i = 0; i < matchLength; i++) dst[op + i] = match[i];
+        }
+        op += matchLength;
+    }
+
+    return (op == dstSize) ? 0 : -1;
+}
@@ -1,6 +1,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,8 +14,13 @@
 #include "renderer.h"
 #include "camera.h"
 #include "renderthread.h"
+#include "meshworker.h"
+#include "genworker.h"
+#include "jobsystem.h"
+#include "rendercommands.h"
 #include "options.h"
-#include "init_blocks_entities.h"
+#include "worldgen.h"
+#include "simulation.h"
 
 // Instance globale du contexte de jeu
 GameContext game = {0};
@@ -25,7 +31,7 @@ int main() {
     
     // Initialiser les valeurs par défaut de la caméra
     game.plPos[X] = 0.0f;
-    game.plPos[Y] = 20.0f;  // Spawner au-dessus du terrain
+    game.plPos[Y] = TERRAIN_BASE_HEIGHT + 20.0f;  // Spawner au-dessus du terrain
     game.plPos[Z] = 0.0f;
     game.cameraFront[X] = 0.0f;
     game.cameraFront[Y] = 0.0f;
@@ -37,25 +43,26 @@ int main() {
     game.pitch = 0.0f;
     game.velocityY = 0.0f;
     game.deltaTime = 0.0f;
-    game.lastFrame = 0.0f;
     
     // Initialiser les options de jeu
     game.options.renderDistance = 12.0f;  // 12 chunks de distance (~192 blocs)
     game.options.fov = 60.0f;             // 60 degrés de FOV
     game.options.vsync = 0;               // VSync désactivé par défaut
     game.options.showFps = 1;             // Afficher les FPS
+    game.options.rebuildBudgetMs = 4.0f;  // 4 ms par frame pour les meshs de chunks
+    game.options.tickRate = 60.0f;        // 60 ticks de simulation par seconde
     
     game.selectedBlockID = 1;             // Default block (Stone)
     
-    // Initialiser le monde AVANT de créer l'atlas
-    // (charge les définitions de blocs depuis blocks.block)
-
-    initBlocksEntities();
+    // Workers partagés par la génération, le maillage et le chargement des ressources
+    initJobSystem();
+    
+    // Initialiser le monde : charge les définitions de blocs depuis blocks.block, avec leurs
+    // modèles et l'atlas de textures (son upload attend le thread de rendu dans la file de commandes)
     initWorld();
     
-    // Créer l'atlas de textures sur le thread principal
-    // (doit être fait avant d'initialiser le thread de rendu)
-    createTextureAtlas();
+    // Précompiler les modèles des blocs (couches de texture connues)
+    compileBlockModels();
     
     // Démarrer le thread de rendu
     // Le contexte OpenGL sera transféré au thread de rendu
@@ -73,58 +80,95 @@ int main() {
     printf("║ F2: Increase Render Distance (+2 chunks)             ║\n");
     printf("║ F3: Toggle FPS Display                                ║\n");
     printf("║ F4: Show Current Options                              ║\n");
+    printf("║ F5/F6: Chunk Rebuild Budget (-/+ 1 ms per frame)     ║\n");
+    printf("║ F7/F8: Simulation Tick Rate (-/+ 10 Hz)              ║\n");
     printf("╚═══════════════════════════════════════════════════════╝\n");
     printGameOptions();
     
     printf("[Main] Boucle principale démarrée (logique du jeu)\n");
     
-    // Initialiser lastFrame pour éviter un deltaTime énorme à la première frame
-    game.lastFrame = glfwGetTime();
+    // Le premier tick est dû immédiatement
+    initSimulationClock(glfwGetTime());
+    float previousPosition[3] = {game.plPos[X], game.plPos[Y], game.plPos[Z]};
+    double lastStatsTime = glfwGetTime();
     
-    // Boucle principale : logique du jeu uniquement
+    // Boucle principale : logique du jeu à pas fixe, le rendu interpole entre les ticks
     while(!glfwWindowShouldClose(window)) {
-        float currentFrame = glfwGetTime();
-        game.deltaTime = currentFrame - game.lastFrame;
-        game.lastFrame = currentFrame;
-
-        // Traiter les entrées utilisateur
-        processInput(window);
+        // Traiter les événements GLFW (clavier, souris) avant les ticks qui les consomment
+        glfwPollEvents();
         
-        // Calculer les matrices view/projection
-        mat4 view, projection;
-        vec3 cameraViewPos = {game.plPos[X], game.plPos[Y] + EYE_HEIGHT, game.plPos[Z]};
-        vec3 target;
-        glm_vec3_add(cameraViewPos, game.cameraFront, target);
-        glm_lookat(cameraViewPos, target, game.cameraUp, view);
+        // Ticks dus depuis la dernière itération (rattrapage borné, voir simulation.h)
+        int ticks = simulationTicksDue(glfwGetTime());
+        for(int t = 0; t < ticks; t++) {
+            double tickStart = glfwGetTime();
+            memcpy(previousPosition, game.plPos, sizeof(previousPosition));
+            game.deltaTime = simulationTickSeconds();
+            
+            // Traiter les entrées utilisateur (déplacement, gravité, collisions)
+            processInput(window);
+            
+            // ICI : Plus tard tu pourras ajouter la logique du jeu
+            // - Mise à jour des mobs
+            // - Physique
+            // - IA
+            // - etc.
+            
+            recordSimulationTick(glfwGetTime() - tickStart);
+        }
         
         int width, height;
         glfwGetFramebufferSize(window, &width, &height);
+        mat4 projection;
         glm_perspective(glm_rad(game.options.fov), (float)width / (float)height, 0.1f, 100.0f, projection);
         
-        // Envoyer les matrices au thread de rendu
-        updateRenderMatrices((float*)view, (float*)projection, 
-                           game.plPos[X], game.plPos[Y], game.plPos[Z],
-                           width, height);
+        // Publier les deux derniers états au thread de rendu (sans attente)
+        // L'orientation est publiée à chaque itération : la souris ne subit pas le pas fixe
+        FrameState* frame = beginFrameState();
+        memcpy(frame->projectionMatrix, projection, sizeof(frame->projectionMatrix));
+        memcpy(frame->previousPosition, previousPosition, sizeof(frame->previousPosition));
+        memcpy(frame->position, game.plPos, sizeof(frame->position));
+        memcpy(frame->cameraFront, game.cameraFront, sizeof(frame->cameraFront));
+        memcpy(frame->cameraUp, game.cameraUp, sizeof(frame->cameraUp));
+        frame->tickTime = simulationTickTime();
+        frame->tickSeconds = simulationTickSeconds();
+        frame->framebufferWidth = width;
+        frame->framebufferHeight = height;
+        frame->selectedBlockID = game.selectedBlockID;
+        frame->options = game.options;
+        publishFrameState();
         
-        // ICI : Plus tard tu pourras ajouter la logique du jeu
-        // - Mise à jour des mobs
-        // - Physique
-        // - IA
-        // - etc.
+        // Charger/décharger les chunks autour du joueur (quelques chunks par frame)
+        updateWorld(game.plPos[X], game.plPos[Z]);
         
-        // Traiter les événements GLFW (clavier, souris)
-        glfwPollEvents();
+        // Remaillages demandés par les modifications de blocs de la frame (un par chunk)
+        flushBlockEdits();
         
-        // Petit sleep pour ne pas saturer le CPU (16ms = ~60 FPS)
-        struct timespec ts = {0, 16000000}; // 16 millisecondes
-        nanosleep(&ts, NULL);
+        double now = glfwGetTime();
+        if(now - lastStatsTime >= 1.0) {
+            reportSimulationStats(game.options.showFps);
+            lastStatsTime = now;
+        }
+        
+        // Dormir jusqu'au prochain tick plutôt qu'une durée fixe
+        double wait = simulationNextTickTime() - glfwGetTime();
+        if(wait > 0.0) {
+            struct timespec ts = {(time_t)wait, (long)((wait - (time_t)wait) * 1e9)};
+            nanosleep(&ts, NULL);
+        }
     }
 
+    // Textures détruites par le thread de rendu avant son arrêt
+    freeTextures();
+    
     // Arrêter proprement le thread de rendu
     stopRenderThread();
+    stopJobSystem();
+    freeGenJobs();
+    freeMeshJobs();
     
-    freeTextures();
     freeWorld();
+    // Destructions postées après l'arrêt du rendu (modèles) : le contexte disparaît avec glfwTerminate
+    freeRenderCommands();
     glfwTerminate();
     
     return 0;
@@ -0,0 +1,264 @@
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesharena.h"
+
+// Pages au démarrage (2M sommets, 16 Mo) ; l'arène double ensuite à la demande
+#define MESH_ARENA_INITIAL_PAGES 8192
+
+// Suite de pages libres
+typedef struct {
+    int first;
+    int count;
+} PageRun;
+
+static unsigned int arenaVAO = 0;
+static unsigned int arenaVBO = 0;
+static int pageCapacity = 0;
+static int maxPages = 0;       // Taille max du texture buffer des origines
+
+// Origine (cx * 16, cz * 16) du chunk propriétaire de chaque page
+static unsigned int originBuffer = 0;
+static unsigned int originTexture = 0;
+
+// Pages libres, triées par première page et fusionnées avec leurs voisines
+static PageRun *freeRuns = NULL;
+static int freeRunCount = 0;
+static int freeRunCapacity = 0;
+
+// Buffer d'indices partagé : le motif (0,1,2)(0,2,3) d'un quad répété quadIndexCapacity fois
+static unsigned int quadIndexBuffer = 0;
+static int quadIndexCapacity = 0;
+
+// Liste de dessin de la passe en cours (paramètres de glMultiDrawElementsBaseVertex)
+static GLsizei *drawCounts = NULL;
+static GLint *drawBaseVertices = NULL;
+static const void **drawIndices = NULL;
+static int drawCount = 0;
+static int drawCapacity = 0;
+
+// Rend une suite de pages libre en la fusionnant avec les suites adjacentes
+static void addFreeRun(int first, int count) {
+    if(count <= 0) return;
+
+    int i = 0;
+    while(i < freeRunCount && freeRuns[i].first < first) i++;
+
+    int mergePrev = (i > 0 && freeRuns[i - 1].first + freeRuns[i - 1].count == first);
+    int mergeNext = (i < freeRunCount && first + count == freeRuns[i].first);
+    if(mergePrev && mergeNext) {
+        freeRuns[i - 1].count += count + freeRuns[i].count;
+        memmove(&freeRuns[i], &freeRuns[i + 1], (freeRunCount - i - 1) * sizeof(PageRun));
+        freeRunCount--;
+    } else if(mergePrev) {
+        freeRuns[i - 1].count += count;
+    } else if(mergeNext) {
+        freeRuns[i].first = first;
+        freeRuns[i].count += count;
+    } else {
+        if(freeRunCount >= freeRunCapacity) {
+            freeRunCapacity = (freeRunCapacity == 0) ? 64 : freeRunCapacity * 2;
+            freeRuns = realloc(freeRuns, freeRunCapacity * sizeof(PageRun));
+        }
+        memmove(&freeRuns[i + 1], &freeRuns[i], (freeRunCount - i) * sizeof(PageRun));
+        freeRuns[i].first = first;
+        freeRuns[i].count = count;
+        freeRunCount++;
+    }
+}
+
+// Première suite libre assez longue (first fit), -1 si aucune
+static int takeFreeRun(int count) {
+    for(int i = 0; i < freeRunCount; i++) {
+        if(freeRuns[i].count < count) continue;
+        int first = freeRuns[i].first;
+        freeRuns[i].first += count;
+        freeRuns[i].count -= count;
+        if(freeRuns[i].count == 0) {
+            memmove(&freeRuns[i], &freeRuns[i + 1], (freeRunCount - i - 1) * sizeof(PageRun));
+            freeRunCount--;
+        }
+        return first;
+    }
+    return -1;
+}
+
+// Remplace un buffer par un plus grand en conservant son contenu (copie côté GPU)
+static unsigned int growBuffer(unsigned int buffer, long oldSize, long newSize) {
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, newSize, NULL, GL_DYNAMIC_DRAW);
+    if(buffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+        glDeleteBuffers(1, &buffer);
+    }
+    return grown;
+}
+
+// Agrandit l'arène d'au moins minPages pages libres, 0 si la limite est atteinte
+static int growArena(int minPages) {
+    int capacity = (pageCapacity > 0) ? pageCapacity * 2 : MESH_ARENA_INITIAL_PAGES;
+    if(capacity < pageCapacity + minPages) capacity = pageCapacity + minPages;
+    if(capacity > maxPages) capacity = maxPages;
+    if(capacity - pageCapacity < minPages) return 0;
+
+    long pageBytes = MESH_ARENA_PAGE_VERTICES * sizeof(ChunkVertex);
+    arenaVBO = growBuffer(arenaVBO, pageCapacity * pageBytes, capacity * pageBytes);
+    originBuffer = growBuffer(originBuffer, pageCapacity * 2 * sizeof(GLint), capacity * 2 * sizeof(GLint));
+
+    // Le VAO et la texture référencent les nouveaux buffers
+    glBindVertexArray(arenaVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, arenaVBO);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glActiveTexture(GL_TEXTURE0 + MESH_ARENA_ORIGIN_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, originTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, originBuffer);
+    glActiveTexture(GL_TEXTURE0);
+
+    addFreeRun(pageCapacity, capacity - pageCapacity);
+    pageCapacity = capacity;
+    printf("[MeshArena] Arène agrandie à %d pages (%.1f Mo)\n", capacity, capacity * pageBytes / (1024.0 * 1024.0));
+    return 1;
+}
+
+// Garantit des indices pour quadCount quads
+// Le nom du buffer ne change pas : le VAO de l'arène voit le nouveau contenu
+static void reserveQuadIndices(int quadCount) {
+    if(quadIndexBuffer != 0 && quadCount <= quadIndexCapacity) return;
+
+    int capacity = (quadIndexCapacity > 0) ? quadIndexCapacity : 4096;
+    while(capacity < quadCount) capacity *= 2;
+
+    uint32_t *indices = malloc(capacity * 6 * sizeof(uint32_t));
+    for(int q = 0; q < capacity; q++) {
+        uint32_t base = (uint32_t)q * 4;
+        uint32_t *quad = &indices[q * 6];
+        quad[0] = base;     quad[1] = base + 1; quad[2] = base + 2;
+        quad[3] = base;     quad[4] = base + 2; quad[5] = base + 3;
+    }
+
+    // Le binding GL_ELEMENT_ARRAY_BUFFER fait partie de l'état du VAO de l'arène
+    glBindVertexArray(arenaVAO);
+    if(quadIndexBuffer == 0) glGenBuffers(1, &quadIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, capacity * 6 * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+    free(indices);
+    quadIndexCapacity = capacity;
+}
+
+void initMeshArena() {
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    maxPages = (maxTexels > 65536) ? maxTexels : 65536;  // Minimum garanti par OpenGL 3.3
+
+    glGenVertexArrays(1, &arenaVAO);
+    glGenTextures(1, &originTexture);
+    reserveQuadIndices(1);
+    growArena(MESH_ARENA_INITIAL_PAGES);
+
+    printf("[MeshArena] Arène de sommets initialisée (%d sommets par page, %d pages max)\n",
+           MESH_ARENA_PAGE_VERTICES, maxPages);
+}
+
+void freeMeshArena() {
+    if(arenaVAO == 0) return;
+
+    glDeleteVertexArrays(1, &arenaVAO);
+    glDeleteBuffers(1, &arenaVBO);
+    glDeleteBuffers(1, &originBuffer);
+    glDeleteTextures(1, &originTexture);
+    glDeleteBuffers(1, &quadIndexBuffer);
+    arenaVAO = arenaVBO = originBuffer = originTexture = quadIndexBuffer = 0;
+    pageCapacity = 0;
+    quadIndexCapacity = 0;
+
+    free(freeRuns);
+    freeRuns = NULL;
+    freeRunCount = freeRunCapacity = 0;
+
+    free(drawCounts);
+    free(drawBaseVertices);
+    free(drawIndices);
+    drawCounts = NULL;
+    drawBaseVertices = NULL;
+    drawIndices = NULL;
+    drawCount = drawCapacity = 0;
+}
+
+int uploadMeshRange(MeshRange *range, const ChunkVertex *vertices, int vertexCount, int cx, int cz) {
+    int pages = (vertexCount + MESH_ARENA_PAGE_VERTICES - 1) >> MESH_ARENA_PAGE_SHIFT;
+
+    if(pages <= range->pageCount) {
+        // Le nouveau mesh tient dans les pages actuelles : la fin est rendue à l'arène
+        addFreeRun(range->firstPage + pages, range->pageCount - pages);
+        range->pageCount = pages;
+    } else {
+        releaseMeshRange(range);
+        int first = takeFreeRun(pages);
+        while(first < 0) {
+            if(!growArena(pages)) {
+                fprintf(stderr, "[MeshArena] Erreur: arène pleine, mesh du chunk (%d, %d) ignoré\n", cx, cz);
+                return 0;
+            }
+            first = takeFreeRun(pages);
+        }
+        range->firstPage = first;
+        range->pageCount = pages;
+
+        // Origine du chunk pour chacune de ses nouvelles pages
+        GLint *origins = malloc(pages * 2 * sizeof(GLint));
+        for(int p = 0; p < pages; p++) {
+            origins[p * 2 + 0] = cx * CHUNK_SIZE_X;
+            origins[p * 2 + 1] = cz * CHUNK_SIZE_Z;
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, originBuffer);
+        glBufferSubData(GL_TEXTURE_BUFFER, (long)first * 2 * sizeof(GLint), pages * 2 * sizeof(GLint), origins);
+        free(origins);
+    }
+    range->vertexCount = vertexCount;
+    if(vertexCount == 0) return 1;
+
+    reserveQuadIndices(vertexCount / 4);
+    glBindBuffer(GL_ARRAY_BUFFER, arenaVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, (long)range->firstPage * MESH_ARENA_PAGE_VERTICES * sizeof(ChunkVertex),
+                    vertexCount * sizeof(ChunkVertex), vertices);
+    return 1;
+}
+
+void releaseMeshRange(MeshRange *range) {
+    if(arenaVAO != 0) addFreeRun(range->firstPage, range->pageCount);
+    range->firstPage = 0;
+    range->pageCount = 0;
+    range->vertexCount = 0;
+}
+
+void queueMeshRange(const MeshRange *range) {
+    if(range->vertexCount == 0) return;
+
+    if(drawCount >= drawCapacity) {
+        drawCapacity = (drawCapacity == 0) ? 256 : drawCapacity * 2;
+        drawCounts = realloc(drawCounts, drawCapacity * sizeof(GLsizei));
+        drawBaseVertices = realloc(drawBaseVertices, drawCapacity * sizeof(GLint));
+        drawIndices = realloc(drawIndices, drawCapacity * sizeof(void*));
+    }
+    drawCounts[drawCount] = QUAD_INDEX_COUNT(range->vertexCount);
+    drawBaseVertices[drawCount] = range->firstPage * MESH_ARENA_PAGE_VERTICES;
+    drawIndices[drawCount] = (const void*)0;  // Tous les meshs commencent au début du motif
+    drawCount++;
+}
+
+void drawQueuedMeshRanges() {
+    if(drawCount == 0) return;
+
+    glActiveTexture(GL_TEXTURE0 + MESH_ARENA_ORIGIN_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, originTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(arenaVAO);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts, GL_UNSIGNED_INT, drawIndices, drawCount, drawBaseVertices);
+    drawCount = 0;
+}
@@ -0,0 +1,166 @@
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GLFW/glfw3.h>
+#include "meshworker.h"
+#include "chunk.h"
+#include "chunkmap.h"
+#include "epoch.h"
+#include "jobsystem.h"
+
+// Un job = un chunk à mailler, avec sa copie de blocs et le résultat CPU
+typedef struct MeshJob {
+    int cx, cz;
+    int ticket;
+    ChunkSnapshot snapshot;
+    ChunkMeshData result;
+    struct MeshJob* next;
+} MeshJob;
+
+// File FIFO simple (liste chaînée)
+typedef struct {
+    MeshJob* head;
+    MeshJob* tail;
+} MeshJobQueue;
+
+// Jobs terminés par les workers, récupérés par le thread de rendu
+static pthread_mutex_t doneMutex = PTHREAD_MUTEX_INITIALIZER;
+static MeshJobQueue finishedJobs = {NULL, NULL};
+// Numéro du dernier job soumis (thread de rendu uniquement, jamais 0)
+static int lastJobTicket = 0;
+
+// Buffers de travail de chaque thread qui exécute des jobs de mesh (voir jobThreadSlot)
+static MeshScratch* scratches[JOB_MAX_THREADS];
+
+// Thread de rendu uniquement : jobs soumis et pas encore uploadés,
+// et jobs terminés mis de côté quand le budget de la frame est épuisé
+static int jobsInFlight = 0;
+static MeshJobQueue readyJobs = {NULL, NULL};
+
+static void pushJob(MeshJobQueue* queue, MeshJob* job) {
+    job->next = NULL;
+    if(queue->tail) queue->tail->next = job;
+    else queue->head = job;
+    queue->tail = job;
+}
+
+static MeshJob* popJob(MeshJobQueue* queue) {
+    MeshJob* job = queue->head;
+    if(job) {
+        queue->head = job->next;
+        if(!queue->head) queue->tail = NULL;
+    }
+    return job;
+}
+
+static void freeJobQueue(MeshJobQueue* queue) {
+    MeshJob* job;
+    while((job = popJob(queue)) != NULL) {
+        freeChunkSnapshot(&job->snapshot);
+        freeChunkMeshData(&job->result);
+        free(job);
+    }
+}
+
+// Job du système de jobs : maille la copie de blocs puis la confie au thread de rendu
+static void buildMeshJob(void* data) {
+    MeshJob* job = data;
+    
+    // Chaque thread garde ses buffers de travail d'un job à l'autre
+    int slot = jobThreadSlot();
+    if(!scratches[slot]) {
+        scratches[slot] = malloc(sizeof(MeshScratch));
+        initMeshScratch(scratches[slot]);
+    }
+    
+    buildChunkMesh(&job->snapshot, scratches[slot], &job->result);
+    freeChunkSnapshot(&job->snapshot);
+    
+    pthread_mutex_lock(&doneMutex);
+    pushJob(&finishedJobs, job);
+    pthread_mutex_unlock(&doneMutex);
+}
+
+void freeMeshJobs() {
+    freeJobQueue(&finishedJobs);
+    freeJobQueue(&readyJobs);
+    jobsInFlight = 0;
+    
+    for(int i = 0; i < JOB_MAX_THREADS; i++) {
+        if(!scratches[i]) continue;
+        freeMeshScratch(scratches[i]);
+        free(scratches[i]);
+        scratches[i] = NULL;
+    }
+}
+
+void submitChunkMesh(Chunk* chunk, const Chunk* neighbors[4]) {
+    MeshJob* job = malloc(sizeof(MeshJob));
+    job->cx = chunk->cx;
+    job->cz = chunk->cz;
+    if(++lastJobTicket <= 0) lastJobTicket = 1;
+    job->ticket = lastJobTicket;
+    memset(&job->result, 0, sizeof(ChunkMeshData));
+    
+    // Une modification publiée après cet échange remarquera ses sections à reconstruire
+    uint16_t sections = atomic_exchange(&chunk->dirtySections, 0);
+    epochEnter();
+    snapshotChunk(chunk, neighbors, sections, &job->snapshot);
+    epochExit();
+    chunk->meshJobPending = job->ticket;
+    jobsInFlight++;
+    
+    submitJob(buildMeshJob, job, NULL);
+}
+
+int canSubmitChunkMesh() {
+    return jobsInFlight < jobWorkerCount() * MESH_JOBS_PER_WORKER;
+}
+
+int meshJobsInFlight() {
+    return jobsInFlight;
+}
+
+int uploadFinishedMeshes(double deadline) {
+    // Récupérer tous les jobs terminés d'un coup pour libérer les workers
+    pthread_mutex_lock(&doneMutex);
+    MeshJobQueue done = finishedJobs;
+    finishedJobs.head = finishedJobs.tail = NULL;
+    pthread_mutex_unlock(&doneMutex);
+    
+    // À la suite des jobs restés en attente : ordre de fin, proche de l'ordre de priorité
+    if(done.head) {
+        if(readyJobs.tail) readyJobs.tail->next = done.head;
+        else readyJobs.head = done.head;
+        readyJobs.tail = done.tail;
+    }
+    
+    int uploaded = 0;
+    MeshJob* job;
+    while(readyJobs.head && (uploaded == 0 || glfwGetTime() < deadline)) {
+        job = popJob(&readyJobs);
+        jobsInFlight--;
+        
+        // Le verrou ne couvre que la recherche : l'upload ne bloque pas les insertions et
+        // retraits du thread principal. Un chunk retiré de la table reste alloué jusqu'à
+        // releaseRetiredChunks (ce thread), et seul ce thread touche mesh et meshJobPending
+        pthread_mutex_lock(&game.world->lock);
+        Chunk* chunk = chunkMapGet(game.world, job->cx, job->cz);
+        pthread_mutex_unlock(&game.world->lock);
+        
+        // Le chunk a pu être déchargé (voire rechargé) pendant la construction :
+        // seul le dernier job soumis pour ce chunk est uploadé
+        if(chunk && chunk->meshJobPending == job->ticket) {
+            uploadChunkMesh(chunk, &job->result);
+            chunk->meshJobPending = 0;
+            uploaded++;
+        }
+        
+        freeChunkMeshData(&job->result);
+        free(job);
+    }
+    
+    return uploaded;
+}
@@ -0,0 +1,267 @@
+#include "noise.h"
+
+// Noyaux x86 : SSE2 fait partie de la base x86-64, AVX2 est détecté à l'exécution
+// (fonctions compilées avec l'attribut target, sans changer les options de compilation)
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define NOISE_X86 1
+#include <immintrin.h>
+#endif
+
+static float smoothNoise2D(float x, float z, int seed) {
+    int intX = (int)x;
+    int intZ = (int)z;
+    float fracX = x - intX;
+    float fracZ = z - intZ;
+
+    // Interpolation bilinéaire
+    float v1 = noise2D(intX, intZ, seed);
+    float v2 = noise2D(intX + 1, intZ, seed);
+    float v3 = noise2D(intX, intZ + 1, seed);
+    float v4 = noise2D(intX + 1, intZ + 1, seed);
+
+    float i1 = v1 * (1 - fracX) + v2 * fracX;
+    float i2 = v3 * (1 - fracX) + v4 * fracX;
+
+    return i1 * (1 - fracZ) + i2 * fracZ;
+}
+
+float perlinNoise2D(float x, float z, int octaves, float persistence, int seed) {
+    float total = 0.0f;
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    float maxValue = 0.0f;
+
+    for(int i = 0; i < octaves; i++) {
+        total += smoothNoise2D(x * frequency, z * frequency, seed) * amplitude;
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0f;
+    }
+
+    return total / maxValue;
+}
+
+// Échantillons z0..depth-1 d'une ligne de la grille en scalaire (lignes plus courtes qu'un vecteur)
+static void noiseRowScalar(float* row, float x, int originZ, int z0, int depth,
+                           float scale, int octaves, float persistence, int seed) {
+    for(int z = z0; z < depth; z++) {
+        row[z] = perlinNoise2D(x, (float)(originZ + z) * scale, octaves, persistence, seed);
+    }
+}
+
+#ifdef NOISE_X86
+
+// === SSE2 : 4 échantillons le long de z ===
+
+// Multiplication 32 bits (mullo) : absente de SSE2, faite sur les lignes paires et impaires
+static inline __m128i mullo32SSE2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// zTerm = z * 57 + seed * 131, partagé par les coins d'une même ligne du réseau
+static inline __m128 noise2DSSE2(__m128i x, __m128i zTerm) {
+    __m128i n = _mm_add_epi32(x, zTerm);
+    n = _mm_xor_si128(_mm_slli_epi32(n, 13), n);
+    __m128i t = mullo32SSE2(n, n);
+    t = _mm_add_epi32(mullo32SSE2(t, _mm_set1_epi32(15731)), _mm_set1_epi32(789221));
+    t = _mm_add_epi32(mullo32SSE2(n, t), _mm_set1_epi32(1376312589));
+    t = _mm_and_si128(t, _mm_set1_epi32(0x7fffffff));
+    // Division par 2^30 : exacte, donc identique à une multiplication par 2^-30
+    __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(t), _mm_set1_ps(1.0f / 1073741824.0f));
+    return _mm_sub_ps(_mm_set1_ps(1.0f), f);
+}
+
+static inline __m128 smoothNoise2DSSE2(__m128 x, __m128 z, __m128i seedTerm) {
+    __m128i intX = _mm_cvttps_epi32(x);
+    __m128i intZ = _mm_cvttps_epi32(z);
+    __m128 fracX = _mm_sub_ps(x, _mm_cvtepi32_ps(intX));
+    __m128 fracZ = _mm_sub_ps(z, _mm_cvtepi32_ps(intZ));
+    __m128i nextX = _mm_add_epi32(intX, _mm_set1_epi32(1));
+    __m128i zTerm = _mm_add_epi32(mullo32SSE2(intZ, _mm_set1_epi32(57)), seedTerm);
+    __m128i nextZTerm = _mm_add_epi32(zTerm, _mm_set1_epi32(57));
+
+    __m128 v1 = noise2DSSE2(intX, zTerm);
+    __m128 v2 = noise2DSSE2(nextX, zTerm);
+    __m128 v3 = noise2DSSE2(intX, nextZTerm);
+    __m128 v4 = noise2DSSE2(nextX, nextZTerm);
+
+    // Mêmes opérations, dans le même ordre, que smoothNoise2D (pas de FMA)
+    __m128 oneF = _mm_set1_ps(1.0f);
+    __m128 invX = _mm_sub_ps(oneF, fracX);
+    __m128 invZ = _mm_sub_ps(oneF, fracZ);
+    __m128 i1 = _mm_add_ps(_mm_mul_ps(v1, invX), _mm_mul_ps(v2, fracX));
+    __m128 i2 = _mm_add_ps(_mm_mul_ps(v3, invX), _mm_mul_ps(v4, fracX));
+    return _mm_add_ps(_mm_mul_ps(i1, invZ), _mm_mul_ps(i2, fracZ));
+}
+
+static void noiseGridSSE2(float* out, int originX, int originZ, int width, int depth,
+                          float scale, int octaves, float persistence, int seed) {
+    __m128i seedTerm = _mm_set1_epi32((int)((uint32_t)seed * 131u));
+    __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+    for(int x = 0; x < width; x++) {
+        float* row = out + (size_t)x * depth;
+        float sampleX = (float)(originX + x) * scale;
+        int z = 0;
+
+        // Fin de ligne : dernier vecteur recalé sur depth - 4 (échantillons recalculés à l'identique)
+        for(; z < depth && depth >= 4; z += 4) {
+            if(z + 4 > depth) z = depth - 4;
+            __m128i worldZ = _mm_add_epi32(_mm_set1_epi32(originZ + z), laneOffsets);
+            __m128 sampleZ = _mm_mul_ps(_mm_cvtepi32_ps(worldZ), _mm_set1_ps(scale));
+
+            __m128 total = _mm_setzero_ps();
+            float frequency = 1.0f;
+            float amplitude = 1.0f;
+            float maxValue = 0.0f;
+            for(int i = 0; i < octaves; i++) {
+                __m128 s = smoothNoise2DSSE2(_mm_set1_ps(sampleX * frequency),
+                                             _mm_mul_ps(sampleZ, _mm_set1_ps(frequency)), seedTerm);
+                total = _mm_add_ps(total, _mm_mul_ps(s, _mm_set1_ps(amplitude)));
+                maxValue += amplitude;
+                amplitude *= persistence;
+                frequency *= 2.0f;
+            }
+            _mm_storeu_ps(row + z, _mm_div_ps(total, _mm_set1_ps(maxValue)));
+        }
+
+        noiseRowScalar(row, sampleX, originZ, z, depth, scale, octaves, persistence, seed);
+    }
+}
+
+// === AVX2 : 8 échantillons le long de z ===
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+static inline AVX2_TARGET __m256 noise2DAVX2(__m256i x, __m256i zTerm) {
+    __m256i n = _mm256_add_epi32(x, zTerm);
+    n = _mm256_xor_si256(_mm256_slli_epi32(n, 13), n);
+    __m256i t = _mm256_mullo_epi32(n, n);
+    t = _mm256_add_epi32(_mm256_mullo_epi32(t, _mm256_set1_epi32(15731)), _mm256_set1_epi32(789221));
+    t = _mm256_add_epi32(_mm256_mullo_epi32(n, t), _mm256_set1_epi32(1376312589));
+    t = _mm256_and_si256(t, _mm256_set1_epi32(0x7fffffff));
+    __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(t), _mm256_set1_ps(1.0f / 1073741824.0f));
+    return _mm256_sub_ps(_mm256_set1_ps(1.0f), f);
+}
+
+static inline AVX2_TARGET __m256 smoothNoise2DAVX2(__m256 x, __m256 z, __m256i seedTerm) {
+    __m256i intX = _mm256_cvttps_epi32(x);
+    __m256i intZ = _mm256_cvttps_epi32(z);
+    __m256 fracX = _mm256_sub_ps(x, _mm256_cvtepi32_ps(intX));
+    __m256 fracZ = _mm256_sub_ps(z, _mm256_cvtepi32_ps(intZ));
+    __m256i nextX = _mm256_add_epi32(intX, _mm256_set1_epi32(1));
+    __m256i zTerm = _mm256_add_epi32(_mm256_mullo_epi32(intZ, _mm256_set1_epi32(57)), seedTerm);
+    __m256i nextZTerm = _mm256_add_epi32(zTerm, _mm256_set1_epi32(57));
+
+    __m256 v1 = noise2DAVX2(intX, zTerm);
+    __m256 v2 = noise2DAVX2(nextX, zTerm);
+    __m256 v3 = noise2DAVX2(intX, nextZTerm);
+    __m256 v4 = noise2DAVX2(nextX, nextZTerm);
+
+    // Pas de FMA : l'arrondi intermédiaire doit rester celui du code scalaire
+    __m256 oneF = _mm256_set1_ps(1.0f);
+    __m256 invX = _mm256_sub_ps(oneF, fracX);
+    __m256 invZ = _mm256_sub_ps(oneF, fracZ);
+    __m256 i1 = _mm256_add_ps(_mm256_mul_ps(v1, invX), _mm256_mul_ps(v2, fracX));
+    __m256 i2 = _mm256_add_ps(_mm256_mul_ps(v3, invX), _mm256_mul_ps(v4, fracX));
+    return _mm256_add_ps(_mm256_mul_ps(i1, invZ), _mm256_mul_ps(i2, fracZ));
+}
+
+static AVX2_TARGET void noiseGridAVX2(float* out, int originX, int originZ, int width, int depth,
+                                      float scale, int octaves, float persistence, int seed) {
+    __m256i seedTerm = _mm256_set1_epi32((int)((uint32_t)seed * 131u));
+    __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for(int x = 0; x < width; x++) {
+        float* row = out + (size_t)x * depth;
+        float sampleX = (float)(originX + x) * scale;
+        int z = 0;
+
+        for(; z < depth && depth >= 8; z += 8) {
+            if(z + 8 > depth) z = depth - 8;
+            __m256i worldZ = _mm256_add_epi32(_mm256_set1_epi32(originZ + z), laneOffsets);
+            __m256 sampleZ = _mm256_mul_ps(_mm256_cvtepi32_ps(worldZ), _mm256_set1_ps(scale));
+
+            __m256 total = _mm256_setzero_ps();
+            float frequency = 1.0f;
+            float amplitude = 1.0f;
+            float maxValue = 0.0f;
+            for(int i = 0; i < octaves; i++) {
+                __m256 s = smoothNoise2DAVX2(_mm256_set1_ps(sampleX * frequency),
+                                             _mm256_mul_ps(sampleZ, _mm256_set1_ps(frequency)), seedTerm);
+                total = _mm256_add_ps(total, _mm256_mul_ps(s, _mm256_set1_ps(amplitude)));
+                maxValue += amplitude;
+                amplitude *= persistence;
+                frequency *= 2.0f;
+            }
+            _mm256_storeu_ps(row + z, _mm256_div_ps(total, _mm256_set1_ps(maxValue)));
+        }
+
+        noiseRowScalar(row, sampleX, originZ, z, depth, scale, octaves, persistence, seed);
+    }
+}
+
+#endif
+
+static void noiseGridScalar(float* out, int originX, int originZ, int width, int depth,
+                            float scale, int octaves, float persistence, int seed) {
+    for(int x = 0; x < width; x++) {
+        noiseRowScalar(out + (size_t)x * depth, (float)(originX + x) * scale, originZ, 0, depth,
+                       scale, octaves, persistence, seed);
+    }
+}
+
+int isNoiseKernelSupported(NoiseKernel kernel) {
+    switch(kernel) {
+        case NOISE_KERNEL_SCALAR: return 1;
+#ifdef NOISE_X86
+        case NOISE_KERNEL_SSE2: return 1;
+        case NOISE_KERNEL_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return 0;
+    }
+}
+
+NoiseKernel bestNoiseKernel() {
+    if(isNoiseKernelSupported(NOISE_KERNEL_AVX2)) return NOISE_KERNEL_AVX2;
+    if(isNoiseKernelSupported(NOISE_KERNEL_SSE2)) return NOISE_KERNEL_SSE2;
+    return NOISE_KERNEL_SCALAR;
+}
+
+const char* noiseKernelName(NoiseKernel kernel) {
+    switch(kernel) {
+        case NOISE_KERNEL_SCALAR: return "scalaire";
+        case NOISE_KERNEL_SSE2: return "SSE2";
+        case NOISE_KERNEL_AVX2: return "AVX2";
+        default: return "inconnu";
+    }
+}
+
+int noiseGrid2DWithKernel(NoiseKernel kernel, float* out, int originX, int originZ, int width, int depth,
+                          float scale, int octaves, float persistence, int seed) {
+    if(!isNoiseKernelSupported(kernel)) return -1;
+
+    switch(kernel) {
+#ifdef NOISE_X86
+        case NOISE_KERNEL_AVX2:
+            noiseGridAVX2(out, originX, originZ, width, depth, scale, octaves, persistence, seed);
+            break;
+        case NOISE_KERNEL_SSE2:
+            noiseGridSSE2(out, originX, originZ, width, depth, scale, octaves, persistence, seed);
+            break;
+#endif
+        default:
+            noiseGridScalar(out, originX, originZ, width, depth, scale, octaves, persistence, seed);
+            break;
+    }
+    return 0;
+}
+
+void noiseGrid2D(float* out, int originX, int originZ, int width, int depth,
+                 float scale, int octaves, float persistence, int seed) {
+    noiseGrid2DWithKernel(bestNoiseKernel(), out, originX, originZ, width, depth,
+                          scale, octaves, persistence, seed);
+}
@@ -1,7 +1,9 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include <glad/glad.h>
 #include "obp_loader.h"
 
@@ -27,6 +29,162 @@ static int parseLine(char* line, const char* keyword, char* rest) {
     return 0;
 }
 
+const int obpCubeFaceAxes[6][3] = {
+    {2, 0, 1}, {2, 0, 1}, {0, 2, 1}, {0, 2, 1}, {1, 0, 2}, {1, 0, 2}
+};
+// 1 si la face est du côté positif de sa normale
+static const int cubeFacePositive[6] = {1, 0, 0, 1, 0, 1};
+
+#define CUBE_EPSILON 1e-4f
+
+// Ramène une coordonnée normalisée sur 0 ou 1, -1 si elle n'est sur aucune face du cube
+static int snapCubeCoord(float value) {
+    if(fabsf(value) < CUBE_EPSILON) return 0;
+    if(fabsf(value - 1.0f) < CUBE_EPSILON) return 1;
+    return -1;
+}
+
+// Vérifie qu'une face est couverte par ses 2 triangles et que son UV est une translation
+// d'une texture entière (pas de sous-rectangle, pas d'étirement) : elle peut alors être répétée
+static int finishCubeFace(OBPCubeFace* face, int axisA, int axisB) {
+    // Chaque triangle omet un coin du carré : les deux coins omis doivent être opposés
+    int omitted[2];
+    for(int t = 0; t < 2; t++) {
+        int sum = 0;
+        for(int k = 0; k < 3; k++) {
+            float* c = face->corner[t * 3 + k];
+            sum += (int)c[axisA] + 2 * (int)c[axisB];
+        }
+        omitted[t] = 6 - sum;
+    }
+    if((omitted[0] ^ omitted[1]) != 3) return 0;
+    
+    // Pas d'UV le long de chaque axe, mesuré entre deux sommets qui ne diffèrent que sur cet axe
+    int foundA = 0, foundB = 0;
+    for(int i = 0; i < 6; i++) {
+        for(int j = 0; j < 6; j++) {
+            float* ci = face->corner[i];
+            float* cj = face->corner[j];
+            if(ci[axisA] == 0.0f && cj[axisA] == 1.0f && ci[axisB] == cj[axisB]) {
+                face->uvStepA[0] = face->uv[j][0] - face->uv[i][0];
+                face->uvStepA[1] = face->uv[j][1] - face->uv[i][1];
+                foundA = 1;
+            }
+            if(ci[axisB] == 0.0f && cj[axisB] == 1.0f && ci[axisA] == cj[axisA]) {
+                face->uvStepB[0] = face->uv[j][0] - face->uv[i][0];
+                face->uvStepB[1] = face->uv[j][1] - face->uv[i][1];
+                foundB = 1;
+            }
+        }
+    }
+    if(!foundA || !foundB) return 0;
+    
+    // Pas unitaires et orthogonaux : une texture complète par bloc
+    float* a = face->uvStepA;
+    float* b = face->uvStepB;
+    if(fabsf(fabsf(a[0]) + fabsf(a[1]) - 1.0f) > CUBE_EPSILON || fabsf(a[0] * a[1]) > CUBE_EPSILON) return 0;
+    if(fabsf(fabsf(b[0]) + fabsf(b[1]) - 1.0f) > CUBE_EPSILON || fabsf(b[0] * b[1]) > CUBE_EPSILON) return 0;
+    if(fabsf(a[0] * b[0] + a[1] * b[1]) > CUBE_EPSILON) return 0;
+    
+    // L'UV de chaque sommet doit suivre ces pas (mapping affine sur toute la face)
+    for(int k = 0; k < 6; k++) {
+        float da = face->corner[k][axisA] - face->corner[0][axisA];
+        float db = face->corner[k][axisB] - face->corner[0][axisB];
+        for(int c = 0; c < 2; c++) {
+            float expected = face->uv[0][c] + a[c] * da + b[c] * db;
+            if(fabsf(face->uv[k][c] - expected) > CUBE_EPSILON) return 0;
+        }
+    }
+    return 1;
+}
+
+// Reconnaît un cube plein de 16 unités de côté fait de 12 triangles alignés sur ses faces
+// Retourne sa géométrie par face, NULL si le modèle a une autre forme
+static OBPCubeGeometry* detectCubeGeometry(const OBPModel* model) {
+    float minPos[3] = {1e30f, 1e30f, 1e30f};
+    float maxPos[3] = {-1e30f, -1e30f, -1e30f};
+    int triangleCount = 0;
+    
+    for(int b = 0; b < model->boneCount; b++) {
+        const OBPBone* bone = &model->bones[b];
+        if(bone->indexCount % 3 != 0 || bone->texCoordCount < bone->vertexCount) return NULL;
+        for(int i = 0; i < bone->indexCount; i++) {
+            unsigned int idx = bone->indices[i];
+            if(idx >= (unsigned int)bone->vertexCount) return NULL;
+            for(int a = 0; a < 3; a++) {
+                float v = bone->vertices[idx * 3 + a];
+                if(v < minPos[a]) minPos[a] = v;
+                if(v > maxPos[a]) maxPos[a] = v;
+            }
+        }
+        triangleCount += bone->indexCount / 3;
+    }
+    if(triangleCount != 12) return NULL;
+    for(int a = 0; a < 3; a++) {
+        if(fabsf(maxPos[a] - minPos[a] - 16.0f) > CUBE_EPSILON) return NULL;
+    }
+    
+    OBPCubeGeometry geometry;
+    memset(&geometry, 0, sizeof(geometry));
+    int faceTriangles[6] = {0};
+    for(int a = 0; a < 3; a++) geometry.origin[a] = minPos[a] / 16.0f;
+    
+    for(int b = 0; b < model->boneCount; b++) {
+        const OBPBone* bone = &model->bones[b];
+        for(int i = 0; i < bone->indexCount; i += 3) {
+            float c[3][3];
+            for(int k = 0; k < 3; k++) {
+                unsigned int idx = bone->indices[i + k];
+                for(int a = 0; a < 3; a++) {
+                    int snapped = snapCubeCoord((bone->vertices[idx * 3 + a] - minPos[a]) / 16.0f);
+                    if(snapped < 0) return NULL;
+                    c[k][a] = (float)snapped;
+                }
+            }
+            
+            // Normale strictement alignée sur un axe (même convention que le baking des chunks)
+            float e1[3] = { c[1][0]-c[0][0], c[1][1]-c[0][1], c[1][2]-c[0][2] };
+            float e2[3] = { c[2][0]-c[0][0], c[2][1]-c[0][1], c[2][2]-c[0][2] };
+            float n[3] = {
+                e1[1]*e2[2] - e1[2]*e2[1],
+                e1[2]*e2[0] - e1[0]*e2[2],
+                e1[0]*e2[1] - e1[1]*e2[0]
+            };
+            int faceDir;
+            if(n[1] == 0.0f && n[2] == 0.0f && n[0] != 0.0f) faceDir = (n[0] > 0) ? 3 : 2;
+            else if(n[0] == 0.0f && n[2] == 0.0f && n[1] != 0.0f) faceDir = (n[1] > 0) ? 5 : 4;
+            else if(n[0] == 0.0f && n[1] == 0.0f && n[2] != 0.0f) faceDir = (n[2] > 0) ? 0 : 1;
+            else return NULL;
+            
+            // Le triangle doit être posé sur la face du cube qui correspond à sa normale
+            int normalAxis = obpCubeFaceAxes[faceDir][0];
+            for(int k = 0; k < 3; k++) {
+                if(c[k][normalAxis] != (float)cubeFacePositive[faceDir]) return NULL;
+            }
+            if(faceTriangles[faceDir] >= 2) return NULL;
+            
+            OBPCubeFace* face = &geometry.faces[faceDir];
+            for(int k = 0; k < 3; k++) {
+                unsigned int idx = bone->indices[i + k];
+                int slot = faceTriangles[faceDir] * 3 + k;
+                memcpy(face->corner[slot], c[k], sizeof(c[k]));
+                face->uv[slot][0] = bone->texCoords[idx * 2 + 0];
+                face->uv[slot][1] = bone->texCoords[idx * 2 + 1];
+            }
+            faceTriangles[faceDir]++;
+        }
+    }
+    
+    for(int f = 0; f < 6; f++) {
+        if(faceTriangles[f] != 2) return NULL;
+        if(!finishCubeFace(&geometry.faces[f], obpCubeFaceAxes[f][1], obpCubeFaceAxes[f][2])) return NULL;
+    }
+    
+    OBPCubeGeometry* result = malloc(sizeof(OBPCubeGeometry));
+    *result = geometry;
+    return result;
+}
+
 OBPModel* loadOBPModel(const char* filepath) {
     FILE* file = fopen(filepath, "r");
     if (!file) {
@@ -174,13 +332,15 @@ OBPModel* loadOBPModel(const char* filepath) {
             unsigned int v[4], vt[4], vn[4];
             int faceVertices = 0;
             
-            char* token = strtok(rest, " ");
+            // strtok_r : les modèles des blocs sont chargés en parallèle sur les workers
+            char* save = NULL;
+            char* token = strtok_r(rest, " ", &save);
             while (token && faceVertices < 4) {
                 if (sscanf(token, "%u/%u/%u", &v[faceVertices], &vt[faceVertices], &vn[faceVertices]) == 3 ||
                     sscanf(token, "%u/%u", &v[faceVertices], &vt[faceVertices]) == 2) {
                     faceVertices++;
                 }
-                token = strtok(NULL, " ");
+                token = strtok_r(NULL, " ", &save);
             }
             
             // Pour chaque vertex de la face, créer un vertex dupliqué avec son UV
@@ -299,18 +459,12 @@ OBPModel* loadOBPModel(const char* filepath) {
     
     fclose(file);
     
-    // Générer les buffers OpenGL pour chaque bone
+    // Confier la création des buffers OpenGL de chaque bone au thread de rendu
     for (int i = 0; i < model->boneCount; i++) {
         OBPBone* bone = &model->bones[i];
+        bone->mesh = NULL;
         
         if (bone->vertexCount > 0 && bone->indexCount > 0) {
-            glGenVertexArrays(1, &bone->VAO);
-            glGenBuffers(1, &bone->VBO);
-            glGenBuffers(1, &bone->EBO);
-            
-            glBindVertexArray(bone->VAO);
-            
-            glBindBuffer(GL_ARRAY_BUFFER, bone->VBO);
             // Format interleaved: X Y Z U V (5 floats)
             // On doit reconstruire un buffer interleaved car OBP stocke séparément
             float* interleaved = malloc(bone->vertexCount * 5 * sizeof(float));
@@ -328,19 +482,10 @@ OBPModel* loadOBPModel(const char* filepath) {
                 }
             }
             
-            glBufferData(GL_ARRAY_BUFFER, bone->vertexCount * 5 * sizeof(float), interleaved, GL_STATIC_DRAW);
-            free(interleaved);
-            
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bone->EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, bone->indexCount * sizeof(unsigned int), bone->indices, GL_STATIC_DRAW);
-            
-            // Position attribute
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-            glEnableVertexAttribArray(0);
-            
-            // TexCoord attribute
-            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-            glEnableVertexAttribArray(1);
+            // La file garde sa propre copie des indices : le bone conserve les siens
+            unsigned int* indices = malloc(bone->indexCount * sizeof(unsigned int));
+            memcpy(indices, bone->indices, bone->indexCount * sizeof(unsigned int));
+            bone->mesh = postCreateMesh(interleaved, bone->vertexCount, indices, bone->indexCount);
             
             // BlockType attribute (instanced or uniform? Here uniform via glVertexAttrib1f in render loop)
             // Mais le shader attend un attribut vertex pour le type de bloc si on batch.
@@ -350,7 +495,10 @@ OBPModel* loadOBPModel(const char* filepath) {
         }
     }
     
-    printf("OBP chargé: %s (%d bones, %d animations)\n", filepath, model->boneCount, model->animationCount);
+    model->cube = detectCubeGeometry(model);
+    
+    printf("OBP chargé: %s (%d bones, %d animations%s)\n", filepath, model->boneCount, model->animationCount,
+           model->cube ? ", cube plein" : "");
     
     return model;
 }
@@ -365,9 +513,7 @@ void freeOBPModel(OBPModel* model) {
         if (bone->texCoords) free(bone->texCoords);
         if (bone->indices) free(bone->indices);
         
-        if (bone->VAO) glDeleteVertexArrays(1, &bone->VAO);
-        if (bone->VBO) glDeleteBuffers(1, &bone->VBO);
-        if (bone->EBO) glDeleteBuffers(1, &bone->EBO);
+        postDeleteMesh(bone->mesh);
     }
     free(model->bones);
     
@@ -377,6 +523,7 @@ void freeOBPModel(OBPModel* model) {
     }
     free(model->animations);
     
+    free(model->cube);
     free(model);
 }
 
@@ -455,7 +602,8 @@ void renderOBPModel(OBPModel* model, float time, unsigned int shader, mat4 globa
     for (int i = 0; i < model->boneCount; i++) {
         OBPBone* bone = &model->bones[i];
         
-        if (bone->vertexCount == 0) continue;
+        // Buffers pas encore créés par la file de commandes : bone ignoré pour cette frame
+        if (bone->vertexCount == 0 || !bone->mesh || !bone->mesh->VAO) continue;
         
         mat4 currentTransform;
         glm_mat4_copy(globalModel, currentTransform);
@@ -478,7 +626,7 @@ void renderOBPModel(OBPModel* model, float time, unsigned int shader, mat4 globa
         glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, (float*)currentTransform);
         glVertexAttrib1f(2, (float)blockType);
         
-        glBindVertexArray(bone->VAO);
+        glBindVertexArray(bone->mesh->VAO);
         glDrawElements(GL_TRIANGLES, bone->indexCount, GL_UNSIGNED_INT, 0);
     }
 }
@@ -31,6 +31,22 @@ void toggleFpsDisplay(int show) {
     printf("[Options] FPS Display: %s\n", show ? "ON" : "OFF");
 }
 
+void setRebuildBudget(float ms) {
+    if(ms < 0.5f) ms = 0.5f;      // Minimum : la file doit avancer
+    if(ms > 16.0f) ms = 16.0f;    // Maximum : une frame à 60 FPS
+    
+    game.options.rebuildBudgetMs = ms;
+    printf("[Options] Chunk rebuild budget: %.1f ms per frame\n", ms);
+}
+
+void setTickRate(float rate) {
+    if(rate < 10.0f) rate = 10.0f;      // Minimum : la physique reste stable
+    if(rate > 240.0f) rate = 240.0f;    // Maximum : le coût des ticks reste borné
+    
+    game.options.tickRate = rate;
+    printf("[Options] Simulation tick rate: %.0f Hz\n", rate);
+}
+
 void printGameOptions() {
     printf("\n=== Game Options ===\n");
     printf("Render Distance: %.1f chunks (~%.0f blocks)\n", 
@@ -39,5 +55,7 @@ void printGameOptions() {
     printf("FOV: %.1f degrees\n", game.options.fov);
     printf("VSync: %s\n", game.options.vsync ? "ON" : "OFF");
     printf("FPS Display: %s\n", game.options.showFps ? "ON" : "OFF");
+    printf("Chunk Rebuild Budget: %.1f ms per frame\n", game.options.rebuildBudgetMs);
+    printf("Simulation Tick Rate: %.0f Hz\n", game.options.tickRate);
     printf("==================\n\n");
 }
@@ -0,0 +1,284 @@
+#define _DEFAULT_SOURCE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "region.h"
+#include "blockstorage.h"
+#include "lzcodec.h"
+
+#define REGION_CHUNKS (REGION_SIZE * REGION_SIZE)
+#define MAX_OPEN_REGIONS 16
+
+// Taille maximale d'un chunk sérialisé (toutes ses sections)
+#define CHUNK_MAX_SERIALIZED_SIZE (CHUNK_SECTIONS * STORAGE_MAX_SERIALIZED_SIZE)
+
+// Entrée de la table d'une région, en secteurs
+typedef struct {
+    uint32_t sectorOffset;
+    uint32_t sectorCount;
+} RegionEntry;
+
+// En-tête d'un chunk dans la région, suivi des données compressées
+typedef struct {
+    uint32_t rawSize;
+    uint32_t compressedSize;
+} ChunkBlobHeader;
+
+#define REGION_HEADER_SECTORS ((REGION_CHUNKS * sizeof(RegionEntry) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE)
+
+typedef struct {
+    int rx, rz;
+    int fd;
+    const uint8_t* map;      // Projection en lecture seule (MAP_SHARED : voit les écritures)
+    size_t mapSize;
+    size_t fileSize;         // Toujours un multiple de REGION_SECTOR_SIZE
+    RegionEntry table[REGION_CHUNKS];
+    unsigned lastUse;
+} RegionFile;
+
+static RegionFile regions[MAX_OPEN_REGIONS];
+static int regionCount = 0;
+static unsigned regionUseCounter = 0;
+static char regionDir[256] = "";
+
+// Tampons de travail (thread principal uniquement)
+static uint8_t rawBuffer[CHUNK_MAX_SERIALIZED_SIZE];
+static uint8_t blobBuffer[sizeof(ChunkBlobHeader) + CHUNK_MAX_SERIALIZED_SIZE + CHUNK_MAX_SERIALIZED_SIZE / 255 + 16];
+
+// Division arrondie vers -inf
+static inline int chunkToRegion(int c) {
+    return (c >= 0) ? c / REGION_SIZE : (c + 1) / REGION_SIZE - 1;
+}
+
+static int mapRegion(RegionFile* region) {
+    if(region->map) munmap((void*)region->map, region->mapSize);
+    region->map = mmap(NULL, region->fileSize, PROT_READ, MAP_SHARED, region->fd, 0);
+    if(region->map == MAP_FAILED) {
+        region->map = NULL;
+        region->mapSize = 0;
+        return -1;
+    }
+    region->mapSize = region->fileSize;
+    return 0;
+}
+
+static void closeRegion(RegionFile* region) {
+    if(region->map) munmap((void*)region->map, region->mapSize);
+    close(region->fd);
+    region->map = NULL;
+    region->fd = -1;
+}
+
+// Ferme une région en cours d'ouverture et libère son emplacement du cache
+static void dropRegion(RegionFile* region) {
+    if(region->fd >= 0) close(region->fd);
+    regionCount--;
+    *region = regions[regionCount];
+}
+
+static RegionFile* openRegion(int rx, int rz) {
+    for(int i = 0; i < regionCount; i++) {
+        if(regions[i].rx == rx && regions[i].rz == rz) {
+            regions[i].lastUse = ++regionUseCounter;
+            return &regions[i];
+        }
+    }
+
+    // Cache plein : fermer la région la moins récemment utilisée
+    RegionFile* region;
+    if(regionCount < MAX_OPEN_REGIONS) {
+        region = &regions[regionCount++];
+    } else {
+        region = &regions[0];
+        for(int i = 1; i < regionCount; i++) {
+            if(regions[i].lastUse < region->lastUse) region = &regions[i];
+        }
+        closeRegion(region);
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/r.%d.%d.reg", regionDir, rx, rz);
+
+    memset(region, 0, sizeof(RegionFile));
+    region->rx = rx;
+    region->rz = rz;
+    region->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if(region->fd < 0) {
+        fprintf(stderr, "Erreur: impossible d'ouvrir la région %s (%s)\n", path, strerror(errno));
+        dropRegion(region);
+        return NULL;
+    }
+
+    struct stat st;
+    if(fstat(region->fd, &st) != 0) {
+        fprintf(stderr, "Erreur: impossible de lire la taille de la région %s (%s)\n", path, strerror(errno));
+        dropRegion(region);
+        return NULL;
+    }
+    size_t headerBytes = REGION_HEADER_SECTORS * REGION_SECTOR_SIZE;
+    region->fileSize = (size_t)st.st_size;
+
+    // Nouveau fichier (ou tronqué) : table vide
+    if(region->fileSize < headerBytes) {
+        if(ftruncate(region->fd, headerBytes) != 0) {
+            fprintf(stderr, "Erreur: impossible d'initialiser la région %s (%s)\n", path, strerror(errno));
+            dropRegion(region);
+            return NULL;
+        }
+        region->fileSize = headerBytes;
+    }
+    region->fileSize -= region->fileSize % REGION_SECTOR_SIZE;
+
+    if(mapRegion(region) == 0) {
+        memcpy(region->table, region->map, sizeof(region->table));
+    }
+    region->lastUse = ++regionUseCounter;
+    return region;
+}
+
+int initRegionStorage(const char* worldDir) {
+    snprintf(regionDir, sizeof(regionDir), "%s", worldDir);
+    if(mkdir(regionDir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Erreur: impossible de créer le dossier du monde '%s' (%s)\n", regionDir, strerror(errno));
+        regionDir[0] = '\0';
+        return -1;
+    }
+    return 0;
+}
+
+void closeRegionStorage() {
+    for(int i = 0; i < regionCount; i++) {
+        closeRegion(&regions[i]);
+    }
+    regionCount = 0;
+}
+
+// Lit les sections sérialisées ; en cas d'erreur le chunk est remis à l'air
+static int decodeChunk(Chunk* chunk, const uint8_t* raw, size_t rawSize) {
+    size_t offset = 0;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        BlockStorage* section = privateChunkSection(chunk, s);
+        int consumed = deserializeStorage(section, raw + offset, rawSize - offset);
+        int valid = (consumed > 0);
+        for(int i = 0; valid && i < section->paletteSize; i++) {
+            if(section->palette[i] >= game.blockCount) valid = 0;
+        }
+        if(!valid) {
+            for(int r = 0; r <= s; r++) fillStorage(privateChunkSection(chunk, r), BLOCK_AIR);
+            return -1;
+        }
+        offset += consumed;
+    }
+    return 0;
+}
+
+int loadChunkFromRegion(Chunk* chunk) {
+    if(!regionDir[0]) return 0;
+
+    int rx = chunkToRegion(chunk->cx);
+    int rz = chunkToRegion(chunk->cz);
+    RegionFile* region = openRegion(rx, rz);
+    if(!region) return 0;
+
+    RegionEntry entry = region->table[(chunk->cz - rz * REGION_SIZE) * REGION_SIZE + (chunk->cx - rx * REGION_SIZE)];
+    if(entry.sectorCount == 0) return 0;
+
+    size_t start = (size_t)entry.sectorOffset * REGION_SECTOR_SIZE;
+    size_t length = (size_t)entry.sectorCount * REGION_SECTOR_SIZE;
+    if(start < REGION_HEADER_SECTORS * REGION_SECTOR_SIZE || start + length > region->fileSize) return 0;
+
+    // Le fichier a grandi depuis la projection : la refaire
+    if(start + length > region->mapSize && mapRegion(region) != 0) return 0;
+
+    ChunkBlobHeader header;
+    memcpy(&header, region->map + start, sizeof(header));
+    if(header.rawSize > CHUNK_MAX_SERIALIZED_SIZE || header.compressedSize > length - sizeof(header) ||
+       lzDecompress(region->map + start + sizeof(header), header.compressedSize, rawBuffer, header.rawSize) != 0 ||
+       decodeChunk(chunk, rawBuffer, header.rawSize) != 0) {
+        fprintf(stderr, "Attention: chunk (%d, %d) corrompu dans la région (%d, %d), régénéré\n",
+                chunk->cx, chunk->cz, rx, rz);
+        return 0;
+    }
+    return 1;
+}
+
+int saveChunkToRegion(const Chunk* chunk) {
+    if(!regionDir[0]) return -1;
+
+    int rx = chunkToRegion(chunk->cx);
+    int rz = chunkToRegion(chunk->cz);
+    RegionFile* region = openRegion(rx, rz);
+    if(!region) return -1;
+
+    size_t rawSize = 0;
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        rawSize += serializeStorage(chunkSection(chunk, s), rawBuffer + rawSize);
+    }
+
+    ChunkBlobHeader header;
+    header.rawSize = (uint32_t)rawSize;
+    header.compressedSize = (uint32_t)lzCompress(rawBuffer, rawSize, blobBuffer + sizeof(header));
+    memcpy(blobBuffer, &header, sizeof(header));
+    size_t blobSize = sizeof(header) + header.compressedSize;
+    uint32_t sectors = (uint32_t)((blobSize + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+
+    // Réécrire sur place si le chunk tient dans ses secteurs, sinon ajouter en fin de fichier
+    // (l'ancien emplacement est abandonné, il n'y a pas de compactage)
+    int index = (chunk->cz - rz * REGION_SIZE) * REGION_SIZE + (chunk->cx - rx * REGION_SIZE);
+    RegionEntry entry = region->table[index];
+    if(entry.sectorCount < sectors) {
+        entry.sectorOffset = (uint32_t)(region->fileSize / REGION_SECTOR_SIZE);
+        entry.sectorCount = sectors;
+    }
+
+    off_t start = (off_t)entry.sectorOffset * REGION_SECTOR_SIZE;
+    if(pwrite(region->fd, blobBuffer, blobSize, start) != (ssize_t)blobSize) {
+        fprintf(stderr, "Erreur: écriture du chunk (%d, %d) impossible\n", chunk->cx, chunk->cz);
+        return -1;
+    }
+
+    size_t end = (size_t)start + (size_t)entry.sectorCount * REGION_SECTOR_SIZE;
+    if(end > region->fileSize) {
+        if(ftruncate(region->fd, end) != 0) return -1;
+        region->fileSize = end;
+    }
+
+    // La table n'est mise à jour qu'une fois les données écrites
+    region->table[index] = entry;
+    if(pwrite(region->fd, &entry, sizeof(entry), index * sizeof(RegionEntry)) != (ssize_t)sizeof(entry)) {
+        return -1;
+    }
+    return 0;
+}
+
+int loadWorldSeed(int* seed) {
+    if(!regionDir[0]) return 0;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/level.dat", regionDir);
+    FILE* file = fopen(path, "r");
+    if(!file) return 0;
+
+    int found = (fscanf(file, "seed %d", seed) == 1);
+    fclose(file);
+    return found;
+}
+
+void saveWorldSeed(int seed) {
+    if(!regionDir[0]) return;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/level.dat", regionDir);
+    FILE* file = fopen(path, "w");
+    if(!file) {
+        fprintf(stderr, "Erreur: impossible d'écrire %s\n", path);
+        return;
+    }
+    fprintf(file, "seed %d\n", seed);
+    fclose(file);
+}
@@ -0,0 +1,202 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include "rendercommands.h"
+
+typedef enum {
+    RENDER_COMMAND_CREATE_MESH,
+    RENDER_COMMAND_DELETE_MESH,
+    RENDER_COMMAND_CREATE_TEXTURE_ARRAY,
+    RENDER_COMMAND_DELETE_TEXTURE
+} RenderCommandType;
+
+// Commande typée ; les pointeurs de données appartiennent à la file
+typedef struct {
+    RenderCommandType type;
+    union {
+        struct {
+            GpuMesh* mesh;
+            float* vertices;
+            int vertexCount;
+            unsigned int* indices;
+            int indexCount;
+        } createMesh;
+        struct {
+            GpuMesh* mesh;
+        } deleteMesh;
+        struct {
+            unsigned int* texture;
+            int size, layers;
+            unsigned char* pixels;
+        } createTexture;
+        struct {
+            unsigned int* texture;
+        } deleteTexture;
+    };
+} RenderCommand;
+
+// Tampon circulaire, agrandi quand il est plein : une publication ne bloque jamais
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+static RenderCommand* commands = NULL;
+static int capacity = 0;
+static int head = 0;           // Prochaine commande à exécuter
+static int count = 0;
+
+static void pushCommand(const RenderCommand* command) {
+    pthread_mutex_lock(&queueMutex);
+    if(count >= capacity) {
+        // Dérouler le tampon dans un plus grand, la plus ancienne commande en tête
+        int grown = (capacity == 0) ? 64 : capacity * 2;
+        RenderCommand* resized = malloc(grown * sizeof(RenderCommand));
+        for(int i = 0; i < count; i++) {
+            resized[i] = commands[(head + i) % capacity];
+        }
+        free(commands);
+        commands = resized;
+        capacity = grown;
+        head = 0;
+    }
+    commands[(head + count) % capacity] = *command;
+    count++;
+    pthread_mutex_unlock(&queueMutex);
+}
+
+static int popCommand(RenderCommand* command) {
+    pthread_mutex_lock(&queueMutex);
+    int popped = (count > 0);
+    if(popped) {
+        *command = commands[head];
+        head = (head + 1) % capacity;
+        count--;
+    }
+    pthread_mutex_unlock(&queueMutex);
+    return popped;
+}
+
+// Libère les données CPU d'une commande exécutée ou abandonnée
+static void releaseCommand(RenderCommand* command) {
+    switch(command->type) {
+        case RENDER_COMMAND_CREATE_MESH:
+            free(command->createMesh.vertices);
+            free(command->createMesh.indices);
+            break;
+        case RENDER_COMMAND_DELETE_MESH:
+            free(command->deleteMesh.mesh);
+            break;
+        case RENDER_COMMAND_CREATE_TEXTURE_ARRAY:
+            free(command->createTexture.pixels);
+            break;
+        case RENDER_COMMAND_DELETE_TEXTURE:
+            break;
+    }
+}
+
+static void executeCommand(RenderCommand* command) {
+    switch(command->type) {
+        case RENDER_COMMAND_CREATE_MESH: {
+            GpuMesh* mesh = command->createMesh.mesh;
+            glGenVertexArrays(1, &mesh->VAO);
+            glGenBuffers(1, &mesh->VBO);
+            glGenBuffers(1, &mesh->EBO);
+
+            glBindVertexArray(mesh->VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, mesh->VBO);
+            glBufferData(GL_ARRAY_BUFFER, command->createMesh.vertexCount * 5 * sizeof(float),
+                         command->createMesh.vertices, GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, command->createMesh.indexCount * sizeof(unsigned int),
+                         command->createMesh.indices, GL_STATIC_DRAW);
+
+            // Position puis UV
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            glBindVertexArray(0);
+            break;
+        }
+        case RENDER_COMMAND_DELETE_MESH: {
+            GpuMesh* mesh = command->deleteMesh.mesh;
+            if(mesh->VAO) glDeleteVertexArrays(1, &mesh->VAO);
+            if(mesh->VBO) glDeleteBuffers(1, &mesh->VBO);
+            if(mesh->EBO) glDeleteBuffers(1, &mesh->EBO);
+            break;
+        }
+        case RENDER_COMMAND_CREATE_TEXTURE_ARRAY: {
+            int size = command->createTexture.size;
+            glGenTextures(1, command->createTexture.texture);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, *command->createTexture.texture);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, command->createTexture.layers, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, command->createTexture.pixels);
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            break;
+        }
+        case RENDER_COMMAND_DELETE_TEXTURE:
+            if(*command->deleteTexture.texture != 0) {
+                glDeleteTextures(1, command->deleteTexture.texture);
+                *command->deleteTexture.texture = 0;
+            }
+            break;
+    }
+    releaseCommand(command);
+}
+
+GpuMesh* postCreateMesh(float* vertices, int vertexCount, unsigned int* indices, int indexCount) {
+    GpuMesh* mesh = calloc(1, sizeof(GpuMesh));
+    RenderCommand command = { .type = RENDER_COMMAND_CREATE_MESH };
+    command.createMesh.mesh = mesh;
+    command.createMesh.vertices = vertices;
+    command.createMesh.vertexCount = vertexCount;
+    command.createMesh.indices = indices;
+    command.createMesh.indexCount = indexCount;
+    pushCommand(&command);
+    return mesh;
+}
+
+void postDeleteMesh(GpuMesh* mesh) {
+    if(!mesh) return;
+    RenderCommand command = { .type = RENDER_COMMAND_DELETE_MESH };
+    command.deleteMesh.mesh = mesh;
+    pushCommand(&command);
+}
+
+void postCreateTextureArray(unsigned int* texture, int size, int layers, unsigned char* pixels) {
+    RenderCommand command = { .type = RENDER_COMMAND_CREATE_TEXTURE_ARRAY };
+    command.createTexture.texture = texture;
+    command.createTexture.size = size;
+    command.createTexture.layers = layers;
+    command.createTexture.pixels = pixels;
+    pushCommand(&command);
+}
+
+void postDeleteTexture(unsigned int* texture) {
+    RenderCommand command = { .type = RENDER_COMMAND_DELETE_TEXTURE };
+    command.deleteTexture.texture = texture;
+    pushCommand(&command);
+}
+
+int executeRenderCommands(double deadline) {
+    int executed = 0;
+    RenderCommand command;
+    while((deadline < 0.0 || executed == 0 || glfwGetTime() < deadline) && popCommand(&command)) {
+        executeCommand(&command);
+        executed++;
+    }
+    return executed;
+}
+
+void freeRenderCommands() {
+    RenderCommand command;
+    while(popCommand(&command)) {
+        releaseCommand(&command);
+    }
+    free(commands);
+    commands = NULL;
+    capacity = head = count = 0;
+}
@@ -6,7 +6,11 @@
 #include <cglm/cglm.h>
 #include "renderer.h"
 #include "chunk.h"
+#include "mesharena.h"
 #include "entities.h"
+#include "meshworker.h"
+#include "world.h"
+#include "chunkmap.h"
 
 #define SCR_WIDTH 800
 #define SCR_HEIGHT 600
@@ -30,16 +34,71 @@ void initGLFW(GLFWwindow **window) {
         printf("Erreur : GLAD n'a pas pu charger OpenGL\n");
         exit(-1);
     }
-
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
+    // L'état OpenGL est fixé par le thread de rendu, seul à appeler OpenGL
 }
 
+// Constante entière C insérée dans le source d'un shader
+#define SHADER_INT(value) SHADER_INT_TEXT(value)
+#define SHADER_INT_TEXT(value) #value
+
+// Shader des chunks : décode les sommets compressés (ChunkVertex, voir chunk.h)
+// La couche de texture est précalculée par sommet ; seule la frame d'animation est ajoutée
+// Tous les chunks partagent l'arène de sommets : l'origine du chunk est celle de la page
+// du sommet (gl_VertexID inclut le base vertex du draw, voir mesharena.h)
 unsigned int createShaderProgram() {
+    const char* vertexShaderSource = "#version 330 core\n"
+    "layout(location=0) in uvec2 aPacked;\n"
+    "out vec2 TexCoord;\n"
+    "flat out int Layer;\n"
+    "uniform mat4 view, projection;\n"
+    "uniform isamplerBuffer chunkOrigins;\n"
+    "uniform float time;\n"
+    "uniform int animFrames[64];\n"
+    "uniform int maxFrames;\n"
+    "void main(){\n"
+    "    uint p = aPacked.x;\n"
+    "    uint t = aPacked.y;\n"
+    "    vec3 pos = vec3(float(p & 511u) - 128.0, float(p >> 18) - 256.0, float((p >> 9) & 511u) - 128.0) / 16.0;\n"
+    "    ivec2 origin = texelFetch(chunkOrigins, gl_VertexID >> " SHADER_INT(MESH_ARENA_PAGE_SHIFT) ").xy;\n"
+    "    pos += vec3(float(origin.x), 0.0, float(origin.y));\n"
+    "    gl_Position = projection * view * vec4(pos, 1.0);\n"
+    "    TexCoord = vec2(float(t & 1023u), float((t >> 10) & 1023u)) / 16.0;\n"
+    "    int layer = int(t >> 20);\n"
+    "    int frames = animFrames[min(layer / maxFrames + 1, 63)];\n"
+    "    Layer = (frames > 1) ? layer + int(mod(floor(time * 8.0), float(frames))) : layer;\n"
+    "}\n";
+
+    const char* fragmentShaderSource = "#version 330 core\n"
+    "in vec2 TexCoord;\n"
+    "flat in int Layer;\n"
+    "out vec4 FragColor;\n"
+    "uniform sampler2DArray blockTexture;\n"
+    "void main(){\n"
+    "    vec4 texColor = texture(blockTexture, vec3(TexCoord, float(Layer)));\n"
+    "    if(texColor.a < 0.1) discard;\n"
+    "    FragColor = texColor;\n"
+    "}\n";
+
+    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+    glCompileShader(vertexShader);
+
+    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+    glCompileShader(fragmentShader);
+
+    unsigned int shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    return shaderProgram;
+}
+
+// Shader des TileEntities : sommets flottants des modèles OBP, type de bloc en attribut
+unsigned int createEntityShaderProgram() {
     const char* vertexShaderSource = "#version 330 core\n"
     "layout(location=0) in vec3 aPos;\n"
     "layout(location=1) in vec2 aTexCoord;\n"
@@ -113,8 +172,27 @@ unsigned int createCrosshairShader() {
     return shaderProgram;
 }
 
+// Chunks visibles de la frame en cours (thread de rendu uniquement)
+// Restent valides jusqu'à la fin de la frame : la libération des chunks déchargés
+// n'a lieu qu'au début de la frame suivante (releaseRetiredChunks)
+static Chunk** visibleChunks = NULL;
+static int visibleChunkCount = 0;
+static int visibleChunkCapacity = 0;
+
+// Chunks visibles à remailler, triés par priorité (thread de rendu uniquement)
+typedef struct {
+    Chunk* chunk;
+    const Chunk* neighbors[4];
+    float priority;
+} RebuildCandidate;
+
+static RebuildCandidate* rebuildQueue = NULL;
+static int rebuildQueueCount = 0;
+static int rebuildQueueCapacity = 0;
+static int remeshQueueDepth = 0;
+
 // Fonction pour vérifier si un chunk est dans le frustum et à portée
-static inline int isChunkVisible(int cx, int cz, float camX, float camZ) {
+static inline int isChunkVisible(int cx, int cz, float camX, float camZ, float renderDistance) {
     // Position du centre du chunk
     float chunkCenterX = (cx * CHUNK_SIZE_X) + (CHUNK_SIZE_X / 2.0f);
     float chunkCenterZ = (cz * CHUNK_SIZE_Z) + (CHUNK_SIZE_Z / 2.0f);
@@ -124,60 +202,117 @@ static inline int isChunkVisible(int cx, int cz, float camX, float camZ) {
     float dz = chunkCenterZ - camZ;
     float distSq = dx * dx + dz * dz;
     
-    // Render distance (configurable via game.options)
-    float maxRenderDistanceChunks = game.options.renderDistance;
+    // Render distance (configurable via game.options, copiée dans la frame)
+    float maxRenderDistanceChunks = renderDistance;
     float maxDistSq = (maxRenderDistanceChunks * CHUNK_SIZE_X) * (maxRenderDistanceChunks * CHUNK_SIZE_X);
     
     // Culling par distance
     return distSq < maxDistSq;
 }
 
-void drawWorld(unsigned int shader) {
+// Priorité de reconstruction (plus petite = plus urgente) : distance du chunk à la caméra,
+// doublée pour les chunks derrière le joueur (forwardX/Z : direction de vue horizontale normalisée)
+static inline float rebuildPriority(int cx, int cz, float camX, float camZ, float forwardX, float forwardZ) {
+    float dx = (cx * CHUNK_SIZE_X) + (CHUNK_SIZE_X / 2.0f) - camX;
+    float dz = (cz * CHUNK_SIZE_Z) + (CHUNK_SIZE_Z / 2.0f) - camZ;
+    float dist = sqrtf(dx * dx + dz * dz);
+    if(dist < 1e-3f) return 0.0f;
+    
+    float facing = (dx * forwardX + dz * forwardZ) / dist;
+    return dist * (1.5f - 0.5f * facing);
+}
+
+static int compareRebuildCandidates(const void* a, const void* b) {
+    float pa = ((const RebuildCandidate*)a)->priority;
+    float pb = ((const RebuildCandidate*)b)->priority;
+    return (pa > pb) - (pa < pb);
+}
+
+int getRemeshQueueDepth() {
+    return remeshQueueDepth;
+}
+
+void drawWorld(const FrameState *frame, const RenderCamera *camera, unsigned int shader, unsigned int entityShader) {
     // Note: La texture array est déjà bindée dans renderthread.c
     // Note: glClear est fait dans renderthread.c
     
-    // Récupérer position caméra (thread-safe)
-    pthread_mutex_lock(&game.renderThread->mutex);
-    float camX = game.renderThread->cameraX;
-    float camZ = game.renderThread->cameraZ;
-    pthread_mutex_unlock(&game.renderThread->mutex);
+    // Position caméra de la frame (interpolée)
+    float camX = camera->position[X];
+    float camZ = camera->position[Z];
+    // Direction de vue = -3e ligne de la matrice de vue (column-major)
+    float forwardX = -camera->viewMatrix[2];
+    float forwardZ = -camera->viewMatrix[10];
     
-    // Pré-calculer la visibilité des chunks pour éviter de le faire 3 fois
-    // et reconstruire les meshs si nécessaire
-    int chunkVisible[WORLD_CHUNKS_X][WORLD_CHUNKS_Z];
+    float forwardLen = sqrtf(forwardX * forwardX + forwardZ * forwardZ);
+    if(forwardLen > 1e-3f) {
+        forwardX /= forwardLen;
+        forwardZ /= forwardLen;
+    }
     
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            chunkVisible[cx][cz] = isChunkVisible(cx, cz, camX, camZ);
-            
-            if(chunkVisible[cx][cz] && game.world[cx][cz].needsRebuild) {
-                rebuildChunkMesh(cx, cz);
-            }
+    // Budget de la frame pour les uploads et les soumissions de meshs
+    // (au moins un de chaque par frame pour que la file avance toujours)
+    double rebuildDeadline = glfwGetTime() + frame->options.rebuildBudgetMs / 1000.0;
+    
+    // Libérer les chunks déchargés par le thread principal
+    releaseRetiredChunks();
+    
+    // Uploader les meshs terminés par les workers depuis la frame précédente
+    uploadFinishedMeshes(rebuildDeadline);
+    
+    // Pré-calculer la liste des chunks visibles pour éviter de le faire 3 fois
+    // et confier aux workers les meshs à reconstruire
+    ChunkMap *map = game.world;
+    pthread_mutex_lock(&map->lock);
+    
+    if(visibleChunkCapacity < map->count) {
+        visibleChunkCapacity = map->capacity;
+        visibleChunks = realloc(visibleChunks, visibleChunkCapacity * sizeof(Chunk*));
+    }
+    if(rebuildQueueCapacity < visibleChunkCapacity) {
+        rebuildQueueCapacity = visibleChunkCapacity;
+        rebuildQueue = realloc(rebuildQueue, rebuildQueueCapacity * sizeof(RebuildCandidate));
+    }
+    visibleChunkCount = 0;
+    rebuildQueueCount = 0;
+    
+    for(int i = 0; i < map->capacity; i++) {
+        Chunk *chunk = map->slots[i];
+        // Les chunks en cours de génération ne sont ni maillés ni dessinés
+        if(!chunk || chunk->genStage != CHUNK_STAGE_READY) continue;
+        if(!isChunkVisible(chunk->cx, chunk->cz, camX, camZ, frame->options.renderDistance)) continue;
+        
+        visibleChunks[visibleChunkCount++] = chunk;
+        if(chunk->dirtySections && !chunk->meshJobPending) {
+            RebuildCandidate *candidate = &rebuildQueue[rebuildQueueCount++];
+            candidate->chunk = chunk;
+            getChunkNeighbors(chunk, candidate->neighbors);
+            candidate->priority = rebuildPriority(chunk->cx, chunk->cz, camX, camZ, forwardX, forwardZ);
         }
     }
     
+    pthread_mutex_unlock(&map->lock);
+    
+    // Copies des blocs hors du verrou : les sections sont des versions immuables et les
+    // chunks relevés restent alloués jusqu'au prochain releaseRetiredChunks
+    // Les chunks proches et devant la caméra d'abord, dans la limite du budget et des
+    // jobs en vol ; le reste reste marqué et sera reclassé à la frame suivante
+    qsort(rebuildQueue, rebuildQueueCount, sizeof(RebuildCandidate), compareRebuildCandidates);
+    int submitted = 0;
+    while(submitted < rebuildQueueCount && canSubmitChunkMesh()) {
+        if(submitted > 0 && glfwGetTime() >= rebuildDeadline) break;
+        RebuildCandidate *candidate = &rebuildQueue[submitted++];
+        submitChunkMesh(candidate->chunk, candidate->neighbors);
+    }
+    remeshQueueDepth = rebuildQueueCount - submitted + meshJobsInFlight();
+    
     // === PASSE 1: Dessiner les blocs OPAQUES ===
     // Active l'écriture dans le depth buffer
     glDepthMask(GL_TRUE);
     
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            if(!chunkVisible[cx][cz]) continue;
-            
-            Chunk *chunk = &game.world[cx][cz];
-            if(chunk->vertexCount > 0) {
-                glBindVertexArray(chunk->VAO);
-                
-                mat4 model;
-                glm_mat4_identity(model);
-                // Correction de l'alignement : suppression du décalage de -0.5
-                glm_translate(model, (vec3){cx * CHUNK_SIZE_X, 0, cz * CHUNK_SIZE_Z});
-                glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, (float*)model);
-                
-                glDrawArrays(GL_TRIANGLES, 0, chunk->vertexCount);
-            }
-        }
+    for(int i = 0; i < visibleChunkCount; i++) {
+        for(int s = 0; s < CHUNK_SECTIONS; s++) queueMeshRange(&visibleChunks[i]->mesh[s][RENDER_LAYER_SOLID]);
     }
+    drawQueuedMeshRanges();
     
     // === PASSE 2: Dessiner le FEUILLAGE (fleurs) ===
     // Dessiner les fleurs AVANT le verre pour qu'elles soient masquées correctement
@@ -186,27 +321,16 @@ void drawWorld(unsigned int shader) {
     glDepthMask(GL_TRUE);
     glDisable(GL_CULL_FACE);
     
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            if(!chunkVisible[cx][cz]) continue;
-            
-            Chunk *chunk = &game.world[cx][cz];
-            if(chunk->foliageVertexCount > 0) {
-                glBindVertexArray(chunk->foliageVAO);
-                
-                mat4 model;
-                glm_mat4_identity(model);
-                glm_translate(model, (vec3){cx * CHUNK_SIZE_X, 0, cz * CHUNK_SIZE_Z});
-                glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, (float*)model);
-                
-                glDrawArrays(GL_TRIANGLES, 0, chunk->foliageVertexCount);
-            }
-        }
+    for(int i = 0; i < visibleChunkCount; i++) {
+        for(int s = 0; s < CHUNK_SECTIONS; s++) queueMeshRange(&visibleChunks[i]->mesh[s][RENDER_LAYER_CUTOUT]);
     }
+    drawQueuedMeshRanges();
     
     // === PASSE 2.5: Dessiner les TILE ENTITIES (Coffres, Fours, etc.) ===
-    // On les dessine comme des objets opaques
-    drawTileEntities(shader);
+    // On les dessine comme des objets opaques, avec le shader à sommets flottants
+    glUseProgram(entityShader);
+    drawTileEntities(entityShader);
+    glUseProgram(shader);
     
     glEnable(GL_CULL_FACE);
     
@@ -215,88 +339,65 @@ void drawWorld(unsigned int shader) {
     // Garde le culling activé pour les blocs de verre
     glDepthMask(GL_FALSE);
     
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            if(!chunkVisible[cx][cz]) continue;
-            
-            Chunk *chunk = &game.world[cx][cz];
-            if(chunk->transparentVertexCount > 0) {
-                glBindVertexArray(chunk->transparentVAO);
-                
-                mat4 model;
-                glm_mat4_identity(model);
-                glm_translate(model, (vec3){cx * CHUNK_SIZE_X, 0, cz * CHUNK_SIZE_Z});
-                glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, (float*)model);
-                
-                glDrawArrays(GL_TRIANGLES, 0, chunk->transparentVertexCount);
-            }
-        }
+    for(int i = 0; i < visibleChunkCount; i++) {
+        for(int s = 0; s < CHUNK_SECTIONS; s++) queueMeshRange(&visibleChunks[i]->mesh[s][RENDER_LAYER_TRANSLUCENT]);
     }
+    drawQueuedMeshRanges();
     
     // Réactive l'écriture dans le depth buffer
     glDepthMask(GL_TRUE);
 }
 
+// Parcourt les chunks visibles calculés par drawWorld pour la frame en cours
 void drawTileEntities(unsigned int shader) {
-    // Récupérer position caméra pour le culling (optionnel, mais bon pour la perf)
-    pthread_mutex_lock(&game.renderThread->mutex);
-    float camX = game.renderThread->cameraX;
-    float camZ = game.renderThread->cameraZ;
-    pthread_mutex_unlock(&game.renderThread->mutex);
-    
     // Calculer le temps une seule fois pour toutes les entités (optimisation)
     float currentTime = (float)glfwGetTime();
     
     // Stocker temporairement pour éviter appels répétés
     game.currentFrameTime = currentTime;
 
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            // Simple distance check (reuse logic if possible, or just simple dist)
-            if(!isChunkVisible(cx, cz, camX, camZ)) continue;
-
-            Chunk *chunk = &game.world[cx][cz];
-            if(chunk->tileEntityCount == 0) continue;
-
-            for(int i=0; i<chunk->tileEntityCount; i++) {
-                TileEntity *te = &chunk->tileEntities[i];
-                BlockDefinition *def = &game.blocks[te->type];
-
-                if(def->model) {
-                    // Calcul de la matrice modèle
-                    mat4 model;
-                    glm_mat4_identity(model);
-
-                    // 1. Position globale du bloc
-                    float globalX = (cx * CHUNK_SIZE_X) + te->x;
-                    float globalY = te->y;
-                    float globalZ = (cz * CHUNK_SIZE_Z) + te->z;
-                    
-                    glm_translate(model, (vec3){globalX, globalY, globalZ});
-
-                    // 2. Rotation autour du centre du bloc (0.5, 0.5, 0.5)
-                    // On déplace au centre, on tourne, on revient
-                    glm_translate(model, (vec3){0.5f, 0.5f, 0.5f});
-                    
-                    // Rotation basée sur te->rotation (0=Nord, 1=Est, 2=Sud, 3=Ouest)
-                    // Nord = -Z, Est = +X, Sud = +Z, Ouest = -X
-                    float angle = 0.0f;
-                    if(te->rotation == 1) angle = -90.0f;
-                    else if(te->rotation == 2) angle = -180.0f;
-                    else if(te->rotation == 3) angle = -270.0f;
-                    
-                    glm_rotate(model, glm_rad(angle), (vec3){0.0f, 1.0f, 0.0f});
-                    
-                    // 3. Revenir à la position d'origine (coin du bloc)
-                    glm_translate(model, (vec3){-0.5f, -0.5f, -0.5f});
-                    
-                    // Utiliser la fonction de rendu spécifique si elle existe
-                    if(def->renderFunc) {
-                        def->renderFunc(te, def, shader, (float*)model);
-                    } else {
-                        // Fallback: rendu par défaut
-                        renderDefaultDynamic(te, def, shader, (float*)model);
-                    }
+    for(int i = 0; i < visibleChunkCount; i++) {
+        Chunk *chunk = visibleChunks[i];
+        if(chunk->tileEntityCount == 0) continue;
+
+        for(int i=0; i<chunk->tileEntityCount; i++) {
+            TileEntity *te = &chunk->tileEntities[i];
+            BlockDefinition *def = &game.blocks[te->type];
+
+            if(def->model) {
+                // Calcul de la matrice modèle
+                mat4 model;
+                glm_mat4_identity(model);
+
+                // 1. Position globale du bloc
+                float globalX = (chunk->cx * CHUNK_SIZE_X) + te->x;
+                float globalY = te->y;
+                float globalZ = (chunk->cz * CHUNK_SIZE_Z) + te->z;
+                
+                glm_translate(model, (vec3){globalX, globalY, globalZ});
+
+                // 2. Rotation autour du centre du bloc (0.5, 0.5, 0.5)
+                // On déplace au centre, on tourne, on revient
+                glm_translate(model, (vec3){0.5f, 0.5f, 0.5f});
+                
+                // Rotation basée sur te->rotation (0=Nord, 1=Est, 2=Sud, 3=Ouest)
+                // Nord = -Z, Est = +X, Sud = +Z, Ouest = -X
+                float angle = 0.0f;
+                if(te->rotation == 1) angle = -90.0f;
+                else if(te->rotation == 2) angle = -180.0f;
+                else if(te->rotation == 3) angle = -270.0f;
+                
+                glm_rotate(model, glm_rad(angle), (vec3){0.0f, 1.0f, 0.0f});
+                
+                // 3. Revenir à la position d'origine (coin du bloc)
+                glm_translate(model, (vec3){-0.5f, -0.5f, -0.5f});
+                
+                // Utiliser la fonction de rendu spécifique si elle existe
+                if(def->renderFunc) {
+                    def->renderFunc(te, def, shader, (float*)model);
+                } else {
+                    // Fallback: rendu par défaut
+                    renderDefaultDynamic(te, def, shader, (float*)model);
                 }
             }
         }
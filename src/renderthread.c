@@ -4,18 +4,52 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <cglm/cglm.h>
 #include "renderthread.h"
 #include "renderer.h"
 #include "chunk.h"
+#include "mesharena.h"
 #include "types.h"
 #include "textrenderer.h"
+#include "rendercommands.h"
 
 // Variables locales au thread de rendu
 static GLFWwindow* renderWindow = NULL;
 static unsigned int shaderProgram = 0;
+static unsigned int entityShaderProgram = 0;
 static unsigned int crosshairShader = 0;
 static unsigned int crosshairVAO = 0;
 
+// Caméra, texture array et animation : uniforms communs aux shaders du monde
+// Laisse le programme actif
+static void setWorldUniforms(unsigned int program, const float* view, const float* projection,
+                             float time, const int* animFramesArray) {
+    glUseProgram(program);
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, view);
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, projection);
+    glUniform1i(glGetUniformLocation(program, "blockTexture"), 0);
+    glUniform1f(glGetUniformLocation(program, "time"), time);
+    glUniform1i(glGetUniformLocation(program, "maxFrames"), game.atlasMaxFrames);
+    glUniform1iv(glGetUniformLocation(program, "animFrames"), 64, animFramesArray);
+}
+
+// Caméra affichée à l'instant now : position interpolée entre les deux derniers ticks
+// (le rendu a un tick de retard sur la simulation, en échange d'un mouvement fluide)
+static void interpolateCamera(const FrameState* frame, double now, RenderCamera* camera) {
+    float alpha = (float)((now - frame->tickTime) / frame->tickSeconds);
+    if(alpha < 0.0f) alpha = 0.0f;
+    if(alpha > 1.0f) alpha = 1.0f;
+    
+    vec3 eye, target;
+    mat4 view;
+    glm_vec3_lerp((float*)frame->previousPosition, (float*)frame->position, alpha, eye);
+    eye[Y] += EYE_HEIGHT;
+    glm_vec3_add(eye, (float*)frame->cameraFront, target);
+    glm_lookat(eye, target, (float*)frame->cameraUp, view);
+    memcpy(camera->viewMatrix, view, sizeof(camera->viewMatrix));
+    glm_vec3_copy(eye, camera->position);
+}
+
 // Fonction principale du thread de rendu
 static void* renderThreadFunc(void* arg) {
     (void)arg;
@@ -25,9 +59,18 @@ static void* renderThreadFunc(void* arg) {
     // Le contexte OpenGL doit être activé sur ce thread
     glfwMakeContextCurrent(renderWindow);
     
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+    
     // Créer les shaders et VAOs dans le contexte du thread de rendu
     shaderProgram = createShaderProgram();
+    entityShaderProgram = createEntityShaderProgram();
     crosshairShader = createCrosshairShader();
+    initMeshArena();
     
     // Créer le VAO du curseur
     float crosshairVertices[] = {
@@ -56,44 +99,31 @@ static void* renderThreadFunc(void* arg) {
     
     // Boucle de rendu
     while(1) {
-        pthread_mutex_lock(&game.renderThread->mutex);
-        
         // Vérifier si on doit arrêter
-        if(game.renderThread->shouldExit) {
-            pthread_mutex_unlock(&game.renderThread->mutex);
-            break;
-        }
+        if(atomic_load(&game.renderThread->shouldExit)) break;
         
-        // Copier les données de rendu localement
-        float view[16], projection[16];
-        memcpy(view, game.renderThread->viewMatrix, sizeof(view));
-        memcpy(projection, game.renderThread->projectionMatrix, sizeof(projection));
-        int width = game.renderThread->framebufferWidth;
-        int height = game.renderThread->framebufferHeight;
-        float camX = game.renderThread->cameraX;
-        float camY = game.renderThread->cameraY;
-        float camZ = game.renderThread->cameraZ;
-        int selectedBlockID = game.renderThread->selectedBlockID;
+        // Entrées de la frame : un seul échange atomique, sans jamais bloquer le thread principal
+        const FrameState* frame = acquireFrameState();
+        RenderCamera camera;
+        interpolateCamera(frame, glfwGetTime(), &camera);
         
-        pthread_mutex_unlock(&game.renderThread->mutex);
+        // Créations, uploads et destructions postés par les autres threads (avant tout état de la frame)
+        executeRenderCommands(glfwGetTime() + RENDER_COMMAND_BUDGET_MS / 1000.0);
+        const float* view = camera.viewMatrix;
+        const float* projection = frame->projectionMatrix;
+        int width = frame->framebufferWidth;
+        int height = frame->framebufferHeight;
+        int selectedBlockID = frame->selectedBlockID;
         
-        // Rendu (sans mutex pour ne pas bloquer le thread principal)
+        // Rendu
         glViewport(0, 0, width, height);
         // Couleur du ciel (Sky Blue)
         glClearColor(0.53f, 0.81f, 0.92f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
-        // Dessiner le monde
-        glUseProgram(shaderProgram);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection);
-        
-        // Bind texture array et envoyer uniforms d'animation
+        // Bind texture array
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D_ARRAY, game.textureAtlas);
-        glUniform1i(glGetUniformLocation(shaderProgram, "blockTexture"), 0);
-        glUniform1f(glGetUniformLocation(shaderProgram, "time"), (float)glfwGetTime());
-        glUniform1i(glGetUniformLocation(shaderProgram, "maxFrames"), game.atlasMaxFrames);
         
         // Debug: vérifier que textureAtlas est valide
         static int frameCount = 0;
@@ -105,7 +135,7 @@ static void* renderThreadFunc(void* arg) {
         }
         frameCount++;
         
-        // Envoyer tableau animFrames
+        // Tableau animFrames
         static int debugOnce = 0;
         int animFramesArray[64] = {0};
         for(int i = 0; i < game.blockCount && i < 64; i++) {
@@ -120,9 +150,15 @@ static void* renderThreadFunc(void* arg) {
             printf("[RenderThread] maxFrames = %d, textureAtlas = %u\n", game.atlasMaxFrames, game.textureAtlas);
             debugOnce = 1;
         }
-        glUniform1iv(glGetUniformLocation(shaderProgram, "animFrames"), 64, animFramesArray);
         
-        drawWorld(shaderProgram);
+        // Mêmes uniforms pour les chunks et les TileEntities
+        float frameTime = (float)glfwGetTime();
+        setWorldUniforms(entityShaderProgram, view, projection, frameTime, animFramesArray);
+        setWorldUniforms(shaderProgram, view, projection, frameTime, animFramesArray);
+        glUniform1i(glGetUniformLocation(shaderProgram, "chunkOrigins"), MESH_ARENA_ORIGIN_UNIT);
+        
+        // Dessiner le monde
+        drawWorld(frame, &camera, shaderProgram, entityShaderProgram);
         
         // Dessiner le curseur
         glUseProgram(crosshairShader);
@@ -133,10 +169,14 @@ static void* renderThreadFunc(void* arg) {
         updateTextRendererSize(width, height);
         
         // FPS
-        if(game.options.showFps) {
+        if(frame->options.showFps) {
             char fpsText[32];
             snprintf(fpsText, 32, "FPS: %d", currentFPS);
             renderText(fpsText, 10.0f, height - 20.0f, 2.0f, (vec3){1.0f, 1.0f, 0.0f});
+            
+            char remeshText[32];
+            snprintf(remeshText, 32, "Remesh queue: %d", getRemeshQueueDepth());
+            renderText(remeshText, 10.0f, height - 40.0f, 1.5f, (vec3){1.0f, 1.0f, 0.0f});
         }
         
         // Bloc sélectionné
@@ -159,8 +199,8 @@ static void* renderThreadFunc(void* arg) {
         double currentTime = glfwGetTime();
         if(currentTime - lastFpsTime >= 1.0) {
             currentFPS = fpsCounter;
-            if(game.options.showFps) {
-                printf("FPS: %d\n", fpsCounter);
+            if(frame->options.showFps) {
+                printf("FPS: %d (remesh queue: %d)\n", fpsCounter, getRemeshQueueDepth());
             }
             fpsCounter = 0;
             lastFpsTime = currentTime;
@@ -170,6 +210,9 @@ static void* renderThreadFunc(void* arg) {
         // usleep(1000); // 1ms
     }
     
+    // Dernières commandes (destructions postées avant l'arrêt)
+    executeRenderCommands(-1.0);
+    freeMeshArena();
     printf("[RenderThread] Thread de rendu arrêté\n");
     return NULL;
 }
@@ -184,22 +227,27 @@ void initRenderThread(GLFWwindow* window) {
         exit(1);
     }
     
-    // Initialiser le mutex
-    pthread_mutex_init(&game.renderThread->mutex, NULL);
-    
     // Initialiser l'état
     game.renderThread->running = 1;
-    game.renderThread->shouldExit = 0;
-    game.renderThread->framebufferWidth = 800;
-    game.renderThread->framebufferHeight = 600;
-    
-    // Initialiser les matrices à l'identité
-    for(int i = 0; i < 16; i++) {
-        game.renderThread->viewMatrix[i] = 0.0f;
-        game.renderThread->projectionMatrix[i] = 0.0f;
-    }
-    game.renderThread->viewMatrix[0] = game.renderThread->viewMatrix[5] = game.renderThread->viewMatrix[10] = game.renderThread->viewMatrix[15] = 1.0f;
-    game.renderThread->projectionMatrix[0] = game.renderThread->projectionMatrix[5] = game.renderThread->projectionMatrix[10] = game.renderThread->projectionMatrix[15] = 1.0f;
+    atomic_init(&game.renderThread->shouldExit, 0);
+    
+    // Frame par défaut dans les trois emplacements : joueur immobile, projection identité
+    FrameState initial;
+    memset(&initial, 0, sizeof(initial));
+    memcpy(initial.previousPosition, game.plPos, sizeof(initial.previousPosition));
+    memcpy(initial.position, game.plPos, sizeof(initial.position));
+    memcpy(initial.cameraFront, game.cameraFront, sizeof(initial.cameraFront));
+    memcpy(initial.cameraUp, game.cameraUp, sizeof(initial.cameraUp));
+    initial.tickSeconds = 1.0f / game.options.tickRate;
+    initial.projectionMatrix[0] = initial.projectionMatrix[5] = initial.projectionMatrix[10] = initial.projectionMatrix[15] = 1.0f;
+    initial.framebufferWidth = 800;
+    initial.framebufferHeight = 600;
+    initial.selectedBlockID = game.selectedBlockID;
+    initial.options = game.options;
+    for(int i = 0; i < 3; i++) game.renderThread->frames[i] = initial;
+    game.renderThread->writeFrame = 0;
+    game.renderThread->readFrame = 1;
+    atomic_init(&game.renderThread->sharedFrame, 2);
     
     // Détacher le contexte OpenGL du thread principal
     // Le thread de rendu va le récupérer
@@ -218,30 +266,31 @@ void stopRenderThread() {
     printf("[Main] Arrêt du thread de rendu...\n");
     
     // Signaler au thread qu'il doit s'arrêter
-    pthread_mutex_lock(&game.renderThread->mutex);
-    game.renderThread->shouldExit = 1;
-    pthread_mutex_unlock(&game.renderThread->mutex);
+    atomic_store(&game.renderThread->shouldExit, 1);
     
     // Attendre que le thread se termine
     pthread_join(game.renderThread->thread, NULL);
     
-    // Détruire le mutex
-    pthread_mutex_destroy(&game.renderThread->mutex);
-    
     printf("[Main] Thread de rendu arrêté\n");
 }
 
-void updateRenderMatrices(float* view, float* projection, float camX, float camY, float camZ, int width, int height) {
-    pthread_mutex_lock(&game.renderThread->mutex);
-    
-    memcpy(game.renderThread->viewMatrix, view, 16 * sizeof(float));
-    memcpy(game.renderThread->projectionMatrix, projection, 16 * sizeof(float));
-    game.renderThread->cameraX = camX;
-    game.renderThread->cameraY = camY;
-    game.renderThread->cameraZ = camZ;
-    game.renderThread->framebufferWidth = width;
-    game.renderThread->framebufferHeight = height;
-    game.renderThread->selectedBlockID = game.selectedBlockID;
-    
-    pthread_mutex_unlock(&game.renderThread->mutex);
+FrameState* beginFrameState() {
+    return &game.renderThread->frames[game.renderThread->writeFrame];
+}
+
+void publishFrameState() {
+    // Release : le contenu de l'emplacement est visible avant son index
+    int previous = atomic_exchange_explicit(&game.renderThread->sharedFrame,
+                                            game.renderThread->writeFrame | FRAME_STATE_FRESH,
+                                            memory_order_acq_rel);
+    game.renderThread->writeFrame = previous & ~FRAME_STATE_FRESH;
+}
+
+const FrameState* acquireFrameState() {
+    if(atomic_load_explicit(&game.renderThread->sharedFrame, memory_order_relaxed) & FRAME_STATE_FRESH) {
+        int previous = atomic_exchange_explicit(&game.renderThread->sharedFrame,
+                                                game.renderThread->readFrame, memory_order_acq_rel);
+        game.renderThread->readFrame = previous & ~FRAME_STATE_FRESH;
+    }
+    return &game.renderThread->frames[game.renderThread->readFrame];
 }
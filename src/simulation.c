@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include "simulation.h"
+#include "types.h"
+
+static double nextTickTime = 0.0;    // Instant programmé du prochain tick
+static double lastTickTime = 0.0;    // Instant programmé du dernier tick dû
+static SimulationStats stats = {0};
+
+// Ticks depuis le dernier printSimulationStats
+static int windowTicks = 0;
+static double windowTickMs = 0.0;
+static double windowMaxTickMs = 0.0;
+
+void initSimulationClock(double now) {
+    nextTickTime = now;
+    lastTickTime = now;
+}
+
+float simulationTickSeconds() {
+    return 1.0f / game.options.tickRate;
+}
+
+int simulationTicksDue(double now) {
+    double tickSeconds = simulationTickSeconds();
+    int due = 0;
+    while(nextTickTime <= now && due < SIMULATION_MAX_CATCHUP_TICKS) {
+        lastTickTime = nextTickTime;
+        nextTickTime += tickSeconds;
+        due++;
+    }
+
+    // Trop de retard (fenêtre déplacée, chargement...) : repartir de maintenant
+    if(nextTickTime <= now) {
+        long dropped = (long)((now - nextTickTime) / tickSeconds) + 1;
+        stats.droppedTicks += dropped;
+        lastTickTime = now;
+        nextTickTime = now + tickSeconds;
+    }
+    return due;
+}
+
+double simulationTickTime() {
+    return lastTickTime;
+}
+
+double simulationNextTickTime() {
+    return nextTickTime;
+}
+
+void recordSimulationTick(double seconds) {
+    double ms = seconds * 1000.0;
+    stats.ticks++;
+    stats.lastTickMs = ms;
+    if(seconds > simulationTickSeconds()) stats.overruns++;
+
+    windowTicks++;
+    windowTickMs += ms;
+    if(ms > windowMaxTickMs) windowMaxTickMs = ms;
+}
+
+SimulationStats getSimulationStats() {
+    return stats;
+}
+
+void reportSimulationStats(int print) {
+    if(print) {
+        printf("[Simulation] %d ticks/s (cible %.0f), moyenne %.2f ms, max %.2f ms (budget %.1f ms), "
+               "%ld dépassements, %ld ticks abandonnés\n",
+               windowTicks, game.options.tickRate,
+               windowTicks > 0 ? windowTickMs / windowTicks : 0.0, windowMaxTickMs,
+               simulationTickSeconds() * 1000.0, stats.overruns, stats.droppedTicks);
+    }
+    windowTicks = 0;
+    windowTickMs = 0.0;
+    windowMaxTickMs = 0.0;
+}
@@ -1,10 +1,10 @@
-#include <glad/glad.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "types.h"
 #include "texture.h"
 #include "lodepng/lodepng.h"
+#include "rendercommands.h"
 
 void createTextureAtlas() {
     // Déterminer les dimensions et compter les frames
@@ -91,30 +91,23 @@ void createTextureAtlas() {
         game.blocks[i].pixelData = NULL;
     }
     
-    // Créer GL_TEXTURE_2D_ARRAY
-    glGenTextures(1, &game.textureAtlas);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, game.textureAtlas);
-    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, texSize, texSize, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlasData);
-    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
-    
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    // Créer GL_TEXTURE_2D_ARRAY sur le thread de rendu (la file libère atlasData)
+    postCreateTextureArray(&game.textureAtlas, texSize, layers, atlasData);
     
     game.atlasMaxFrames = maxFrames;
     
-    free(atlasData);
-    printf("Texture Array créée avec succès\n");
+    // Couche de base de chaque bloc, précalculée dans les sommets des chunks
+    game.blocks[0].textureLayer = 0;
+    for(int i = 1; i < game.blockCount; i++) {
+        game.blocks[i].textureLayer = (i - 1) * maxFrames;
+    }
+    
+    printf("Texture Array préparée (upload par le thread de rendu)\n");
 }
 
 void freeTextures() {
-    if(game.textureAtlas != 0) {
-        glDeleteTextures(1, &game.textureAtlas);
-    }
+    postDeleteTexture(&game.textureAtlas);
     for(int i = 1; i < game.blockCount; i++) {
-        if(game.blocks[i].textureID != 0) {
-            glDeleteTextures(1, &game.blocks[i].textureID);
-        }
+        postDeleteTexture(&game.blocks[i].textureID);
     }
 }
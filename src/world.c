@@ -6,10 +6,280 @@
 #include <math.h>
 #include "world.h"
 #include "chunk.h"
+#include "blockstorage.h"
 #include "worldgen.h"
 #include "blockparser.h"
 #include "entityloader.h"
 #include "obp_loader.h"
+#include "chunkmap.h"
+#include "region.h"
+#include "genworker.h"
+#include "blockregistry.h"
+#include "epoch.h"
+
+// Un chunk est gardé jusqu'à STREAM_UNLOAD_MARGIN chunks au-delà du rayon de chargement
+// (évite de charger/décharger en boucle en longeant une frontière)
+#define STREAM_UNLOAD_MARGIN 2
+
+// Nombre maximal de chunks confiés aux workers de génération à un instant donné
+// (les plus proches passent d'abord quand le joueur se déplace)
+#define MAX_PENDING_GENERATIONS 64
+
+// Décalages (dx, dz) du disque de chargement triés par distance croissante
+typedef struct {
+    int dx, dz;
+    int distSq;
+} ChunkOffset;
+
+static ChunkOffset* loadOffsets = NULL;
+static int loadOffsetCount = 0;
+static int loadRadius = -1;
+static int streamCenterX = 0;
+static int streamCenterZ = 0;
+// Premier décalage pas encore vérifié : tout ce qui précède est chargé
+static int nextOffset = 0;
+
+// Statistiques de chargement : chunks lus depuis les régions / générés
+static int chunksLoadedFromDisk = 0;
+static int chunksGenerated = 0;
+
+// Sections à remailler accumulées par les modifications de blocs de la frame (thread principal)
+// Une entrée par chunk : plusieurs modifications du même chunk ne donnent qu'un remaillage
+typedef struct {
+    int cx, cz;
+    uint16_t sections;
+} PendingRemesh;
+
+static PendingRemesh* pendingRemeshes = NULL;
+static int pendingRemeshCount = 0;
+static int pendingRemeshCapacity = 0;
+
+static int compareOffsets(const void* a, const void* b) {
+    return ((const ChunkOffset*)a)->distSq - ((const ChunkOffset*)b)->distSq;
+}
+
+static void buildLoadOffsets(int radius) {
+    free(loadOffsets);
+    loadOffsets = malloc((2 * radius + 1) * (2 * radius + 1) * sizeof(ChunkOffset));
+    loadOffsetCount = 0;
+    for(int dx = -radius; dx <= radius; dx++) {
+        for(int dz = -radius; dz <= radius; dz++) {
+            int distSq = dx * dx + dz * dz;
+            if(distSq > radius * radius) continue;
+            loadOffsets[loadOffsetCount++] = (ChunkOffset){dx, dz, distSq};
+        }
+    }
+    qsort(loadOffsets, loadOffsetCount, sizeof(ChunkOffset), compareOffsets);
+    loadRadius = radius;
+}
+
+Chunk* getChunk(int cx, int cz) {
+    Chunk* chunk = chunkMapGet(game.world, cx, cz);
+    return (chunk && chunk->genStage == CHUNK_STAGE_READY) ? chunk : NULL;
+}
+
+static void queueRemesh(int cx, int cz, uint16_t sections) {
+    for(int i = 0; i < pendingRemeshCount; i++) {
+        if(pendingRemeshes[i].cx == cx && pendingRemeshes[i].cz == cz) {
+            pendingRemeshes[i].sections |= sections;
+            return;
+        }
+    }
+    if(pendingRemeshCount >= pendingRemeshCapacity) {
+        pendingRemeshCapacity = (pendingRemeshCapacity == 0) ? 16 : pendingRemeshCapacity * 2;
+        pendingRemeshes = realloc(pendingRemeshes, pendingRemeshCapacity * sizeof(PendingRemesh));
+    }
+    pendingRemeshes[pendingRemeshCount].cx = cx;
+    pendingRemeshes[pendingRemeshCount].cz = cz;
+    pendingRemeshes[pendingRemeshCount].sections = sections;
+    pendingRemeshCount++;
+}
+
+int setWorldBlock(int worldX, int worldY, int worldZ, BlockType type) {
+    if(worldY < 0 || worldY >= CHUNK_SIZE_Y) return 0;
+    
+    int cx = worldToChunkX(worldX);
+    int cz = worldToChunkZ(worldZ);
+    Chunk* chunk = getChunk(cx, cz);
+    if(!chunk) return 0;
+    
+    int lx = worldX - cx * CHUNK_SIZE_X;
+    int lz = worldZ - cz * CHUNK_SIZE_Z;
+    if(getChunkBlock(chunk, lx, worldY, lz) == type) return 1;
+    
+    // Sans verrou : la section modifiée est publiée comme une nouvelle version
+    setChunkBlock(chunk, lx, worldY, lz, type);
+    chunk->needsSave = 1;
+    
+    // Section du bloc, et sa voisine verticale si le bloc est sur leur frontière
+    queueRemesh(cx, cz, blockMeshSections(worldY));
+    
+    // Bloc en bordure : seule la section de même hauteur du chunk voisin voit ce bloc
+    uint16_t section = (uint16_t)(1u << (worldY / SECTION_SIZE));
+    if(lx == 0) queueRemesh(cx - 1, cz, section);
+    if(lx == CHUNK_SIZE_X - 1) queueRemesh(cx + 1, cz, section);
+    if(lz == 0) queueRemesh(cx, cz - 1, section);
+    if(lz == CHUNK_SIZE_Z - 1) queueRemesh(cx, cz + 1, section);
+    return 1;
+}
+
+void flushBlockEdits() {
+    if(pendingRemeshCount == 0) return;
+    
+    // Marques atomiques, sans verrou : le thread de rendu soumet ensuite au plus
+    // un job par chunk (pas de nouveau job tant que le précédent est en cours)
+    for(int i = 0; i < pendingRemeshCount; i++) {
+        Chunk* chunk = getChunk(pendingRemeshes[i].cx, pendingRemeshes[i].cz);
+        if(chunk) chunk->dirtySections |= pendingRemeshes[i].sections;
+    }
+    pendingRemeshCount = 0;
+}
+
+static void markChunkDirty(int cx, int cz) {
+    Chunk* chunk = getChunk(cx, cz);
+    if(chunk) chunk->dirtySections = CHUNK_ALL_SECTIONS;
+}
+
+// Le chunk devient visible du maillage et du rendu
+static void setChunkReady(Chunk* chunk) {
+    int cx = chunk->cx, cz = chunk->cz;
+    
+    // Les faces en bordure des voisins dépendent de ce chunk
+    // (sous le verrou : le thread de rendu lit ces drapeaux en parcourant la table)
+    pthread_mutex_lock(&game.world->lock);
+    chunk->genStage = CHUNK_STAGE_READY;
+    chunk->dirtySections = CHUNK_ALL_SECTIONS;
+    markChunkDirty(cx - 1, cz);
+    markChunkDirty(cx + 1, cz);
+    markChunkDirty(cx, cz - 1);
+    markChunkDirty(cx, cz + 1);
+    pthread_mutex_unlock(&game.world->lock);
+}
+
+// Blocs générés installés par collectGeneratedChunks
+static void onChunkGenerated(Chunk* chunk) {
+    chunk->needsSave = 1;
+    chunksGenerated++;
+    setChunkReady(chunk);
+}
+
+// Lit le chunk depuis sa région, ou confie sa génération aux workers
+static void loadChunk(int cx, int cz) {
+    Chunk* chunk = allocChunk(game.world);
+    chunk->cx = cx;
+    chunk->cz = cz;
+    
+    if(loadChunkFromRegion(chunk)) {
+        // Les colonnes ne sont pas sauvegardées : recalculées depuis les sections,
+        // et les biomes depuis la graine
+        computeChunkColumns(chunk);
+        computeChunkBiomes(cx, cz, game.worldSeed, &chunk->columns);
+        chunkMapInsert(game.world, chunk);
+        chunksLoadedFromDisk++;
+        setChunkReady(chunk);
+    } else {
+        // Invisible du rendu tant qu'il n'est pas en CHUNK_STAGE_READY
+        // (étape fixée par submitChunkGeneration avant l'insertion dans la table)
+        submitChunkGeneration(chunk);
+        chunkMapInsert(game.world, chunk);
+    }
+}
+
+static void unloadFarChunks() {
+    int keepRadius = loadRadius + STREAM_UNLOAD_MARGIN;
+    int keepSq = keepRadius * keepRadius;
+    
+    for(int i = 0; i < game.world->capacity; i++) {
+        Chunk* chunk = game.world->slots[i];
+        if(!chunk) continue;
+        int dx = chunk->cx - streamCenterX;
+        int dz = chunk->cz - streamCenterZ;
+        if(dx * dx + dz * dz <= keepSq) continue;
+        
+        // Un chunk incomplet n'est pas sauvegardé : il sera régénéré
+        if(chunk->genStage == CHUNK_STAGE_READY && chunk->needsSave) saveChunkToRegion(chunk);
+        chunkMapRemove(game.world, chunk);
+        retireChunk(game.world, chunk);
+        // La suppression décale les entrées suivantes : revérifier cette case
+        i--;
+    }
+}
+
+static void updateWorldStreaming(float playerX, float playerZ) {
+    // Les blocs sont centrés sur les coordonnées entières en X/Z
+    int centerX = worldToChunkX((int)floorf(playerX + 0.5f));
+    int centerZ = worldToChunkZ((int)floorf(playerZ + 0.5f));
+    int radius = (int)ceilf(game.options.renderDistance) + 1;
+    
+    if(radius == loadRadius && centerX == streamCenterX && centerZ == streamCenterZ) return;
+    
+    if(radius != loadRadius) buildLoadOffsets(radius);
+    streamCenterX = centerX;
+    streamCenterZ = centerZ;
+    nextOffset = 0;
+    
+    unloadFarChunks();
+}
+
+// Charge au plus maxDiskLoads chunks depuis les régions et garde au plus
+// MAX_PENDING_GENERATIONS chunks en génération, les plus proches d'abord
+// Retourne 1 quand toute la zone est chargée ou en cours de génération
+static int loadNearChunks(int maxDiskLoads) {
+    int diskLoads = chunksLoadedFromDisk + maxDiskLoads;
+    while(nextOffset < loadOffsetCount) {
+        if(chunksLoadedFromDisk >= diskLoads || pendingGenerationCount() >= MAX_PENDING_GENERATIONS) break;
+        
+        int cx = streamCenterX + loadOffsets[nextOffset].dx;
+        int cz = streamCenterZ + loadOffsets[nextOffset].dz;
+        if(!chunkMapGet(game.world, cx, cz)) {
+            loadChunk(cx, cz);
+        }
+        nextOffset++;
+    }
+    return nextOffset >= loadOffsetCount;
+}
+
+static void printWorldStats() {
+    size_t storageBytes = 0;
+    int emptySections = 0;
+    for(int i = 0; i < game.world->capacity; i++) {
+        Chunk* chunk = game.world->slots[i];
+        if(!chunk) continue;
+        for(int s = 0; s < CHUNK_SECTIONS; s++) {
+            storageBytes += storageMemoryUsage(chunkSection(chunk, s));
+            if(isStorageEmpty(chunkSection(chunk, s))) emptySections++;
+        }
+    }
+    printf("Blocs: %zu Ko, %zu Ko non compressés, %d/%d sections vides\n", 
+           storageBytes / 1024,
+           (size_t)game.world->count * CHUNK_SECTIONS * SECTION_VOLUME * sizeof(BlockType) / 1024,
+           emptySections, game.world->count * CHUNK_SECTIONS);
+}
+
+static double monotonicSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double worldStartTime = 0.0;
+static int initialZoneReported = 0;
+
+void updateWorld(float playerX, float playerZ) {
+    updateWorldStreaming(playerX, playerZ);
+    collectGeneratedChunks(onChunkGenerated);
+    int complete = loadNearChunks(STREAM_CHUNKS_PER_FRAME);
+    
+    // Versions de sections remplacées que plus aucune copie du rendu ne lit
+    epochReclaim();
+    
+    if(!initialZoneReported && complete && pendingGenerationCount() == 0) {
+        initialZoneReported = 1;
+        printf("Zone initiale prête en %.2f s: %d chunks (%d lus sur disque, %d générés)\n",
+               monotonicSeconds() - worldStartTime, game.world->count, chunksLoadedFromDisk, chunksGenerated);
+        printWorldStats();
+    }
+}
 
 void initWorld() {
     // Charger les définitions de blocs depuis le fichier
@@ -23,56 +293,59 @@ void initWorld() {
     // Charger les configurations d'entités (modèles complexes, renderers)
     loadEntitiesFromFile("tile_entities.block");
     
-    game.world = malloc(WORLD_CHUNKS_X * sizeof(Chunk*));
-    for(int cx=0; cx < WORLD_CHUNKS_X; cx++) {
-        game.world[cx] = malloc(WORLD_CHUNKS_Z * sizeof(Chunk));
-    }
+    game.world = createChunkMap(1024);
     
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++)
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-            game.world[cx][cz].VAO = 0;
-            game.world[cx][cz].VBO = 0;
-            game.world[cx][cz].transparentVAO = 0;
-            game.world[cx][cz].transparentVBO = 0;
-            game.world[cx][cz].foliageVAO = 0;
-            game.world[cx][cz].foliageVBO = 0;
-            game.world[cx][cz].vertexCount = 0;
-            game.world[cx][cz].transparentVertexCount = 0;
-            game.world[cx][cz].foliageVertexCount = 0;
-            game.world[cx][cz].tileEntities = NULL;
-            game.world[cx][cz].tileEntityCount = 0;
-            game.world[cx][cz].tileEntityCapacity = 0;
-            game.world[cx][cz].needsRebuild = 1;
-        }
+    // Monde sauvegardé dans world/ : reprendre sa graine pour générer les chunks manquants
+    // Sans sauvegarde, 0 = seed aléatoire basé sur le temps
+    initRegionStorage("world");
+    int seed = 0;
+    loadWorldSeed(&seed);
+    initWorldGen(seed);
+    saveWorldSeed(game.worldSeed);
     
-    // Génération du monde
-    // Utilise 0 pour un seed aléatoire basé sur le temps
-    // Ou remplace par generateFlatWorld(game.world) pour un monde plat de test
-    generateRandomWorld(game.world, 0);
-    
-    // Générer les mesh de tous les chunks
-    for(int cx=0; cx<WORLD_CHUNKS_X; cx++)
-        for(int cz=0; cz<WORLD_CHUNKS_Z; cz++)
-            rebuildChunkMesh(cx, cz);
+    // Les chunks autour du joueur arrivent ensuite frame par frame (updateWorld) :
+    // lus depuis les régions ou générés par les workers, sans bloquer la boucle de jeu
+    worldStartTime = monotonicSeconds();
+    initialZoneReported = 0;
+}
+
+// Libère les chunks retirés de la table (ressources GL : thread de rendu uniquement)
+void releaseRetiredChunks() {
+    Chunk* chunk = takeRetiredChunks(game.world);
+    while(chunk) {
+        Chunk* next = chunk->nextFree;
+        freeChunkMesh(chunk);
+        releaseChunk(game.world, chunk);
+        chunk = next;
+    }
 }
 
 void freeWorld() {
     if(game.world) {
-        for(int cx=0; cx<WORLD_CHUNKS_X; cx++) {
-            for(int cz=0; cz<WORLD_CHUNKS_Z; cz++) {
-                freeChunkMesh(&game.world[cx][cz]);
-                if(game.world[cx][cz].tileEntities) {
-                    free(game.world[cx][cz].tileEntities);
-                }
-            }
-            free(game.world[cx]);
+        for(int i = 0; i < game.world->capacity; i++) {
+            Chunk* chunk = game.world->slots[i];
+            if(!chunk) continue;
+            if(chunk->genStage == CHUNK_STAGE_READY && chunk->needsSave) saveChunkToRegion(chunk);
+            freeChunkMesh(chunk);
+            releaseChunk(game.world, chunk);
         }
-        free(game.world);
+        releaseRetiredChunks();
+        destroyChunkMap(game.world);
         game.world = NULL;
     }
+    epochReclaimAll();
+    closeRegionStorage();
+    free(pendingRemeshes);
+    pendingRemeshes = NULL;
+    pendingRemeshCount = pendingRemeshCapacity = 0;
+    free(loadOffsets);
+    loadOffsets = NULL;
+    loadOffsetCount = 0;
+    loadRadius = -1;
     
     // Libérer les chaînes et modèles alloués dynamiquement pour les blocs
     if(game.blocks) {
+        freeBlockModels();
         for(int i = 0; i < game.blockCount; i++) {
             if(game.blocks[i].name) {
                 free(game.blocks[i].name);
@@ -87,24 +360,25 @@ void freeWorld() {
         game.blocks = NULL;
     }
     game.blockCount = 0;
+    freeBlockRegistry();
 }
 
 BlockType getBlockAt(int worldX, int worldY, int worldZ) {
     if(worldY < 0 || worldY >= CHUNK_SIZE_Y) return BLOCK_AIR;
     
-    int cx = worldX / CHUNK_SIZE_X;
-    int cz = worldZ / CHUNK_SIZE_Z;
-    if(worldX < 0 && worldX % CHUNK_SIZE_X != 0) cx--;
-    if(worldZ < 0 && worldZ % CHUNK_SIZE_Z != 0) cz--;
+    int cx = worldToChunkX(worldX);
+    int cz = worldToChunkZ(worldZ);
     
-    if(cx < 0 || cx >= WORLD_CHUNKS_X || cz < 0 || cz >= WORLD_CHUNKS_Z) return BLOCK_AIR;
+    Chunk* chunk = getChunk(cx, cz);
+    if(!chunk) return BLOCK_AIR;
     
     int lx = worldX - cx * CHUNK_SIZE_X;
     int lz = worldZ - cz * CHUNK_SIZE_Z;
     
-    if(lx < 0 || lx >= CHUNK_SIZE_X || lz < 0 || lz >= CHUNK_SIZE_Z) return BLOCK_AIR;
+    // Au-dessus du sommet de la colonne : air, sans lire les sections
+    if(worldY >= chunk->columns.height[lx][lz]) return BLOCK_AIR;
     
-    return game.world[cx][cz].blocks[lx][worldY][lz].type;
+    return getChunkBlock(chunk, lx, worldY, lz);
 }
 
 int checkCollisionAABB(vec3 newPos) {
@@ -119,13 +393,24 @@ int checkCollisionAABB(vec3 newPos) {
     int pz = (int)roundf(newPos[Z]);
 
     for(int x = px - 1; x <= px + 1; x++) {
-        for(int y = py - 1; y <= py + 2; y++) {
-            for(int z = pz - 1; z <= pz + 1; z++) {
-                BlockType type = getBlockAt(x, y, z);
+        for(int z = pz - 1; z <= pz + 1; z++) {
+            // Une recherche de chunk par colonne ; le sommet de la colonne borne les blocs à lire
+            int cx = worldToChunkX(x);
+            int cz = worldToChunkZ(z);
+            Chunk* chunk = getChunk(cx, cz);
+            int lx = x - cx * CHUNK_SIZE_X;
+            int lz = z - cz * CHUNK_SIZE_Z;
+            
+            for(int y = py - 1; y <= py + 2; y++) {
+                if(y < 0 || y >= CHUNK_SIZE_Y) continue;
                 
-                // Si c'est un bloc non solide, pas de collision
-                if(!game.blocks[type].solid) 
-                    continue;
+                // Chunk pas encore chargé ou généré : solide, le joueur attend son terrain
+                if(chunk) {
+                    if(y >= chunk->columns.height[lx][lz]) break;
+                    
+                    // Si c'est un bloc non solide, pas de collision
+                    if(!game.blocks[getChunkBlock(chunk, lx, y, lz)].solid) continue;
+                }
                 // Vérification AABB précise
                 // Le bloc est centré en X/Z (x, z) mais commence à Y (y)
                 // X: [x-0.5, x+0.5]
@@ -145,16 +430,3 @@ int checkCollisionAABB(vec3 newPos) {
     }
     return 0;
 }
-
-int findBlockByName(const char* name) {
-    for(int i = 0; i < game.blockCount; i++) {
-        if(!game.blocks[i].name) {
-            fprintf(stderr, "ERREUR: game.blocks[%d].name est NULL\n", i);
-            continue;
-        }
-        if(strcmp(game.blocks[i].name, name) == 0) {
-            return i;
-        }
-    }
-    return -1;
-}
@@ -6,246 +6,286 @@
 #include "worldgen.h"
 #include "types.h"
 #include "world.h"
+#include "blockstorage.h"
+#include "noise.h"
 
-// Générateur de bruit de Perlin simplifié (2D)
-static float noise2D(int x, int z, int seed) {
-    int n = x + z * 57 + seed * 131;
-    n = (n << 13) ^ n;
-    return (1.0f - ((n * (n * n * 15731 + 789221) + 1376312589) & 0x7fffffff) / 1073741824.0f);
+// Marge de colonnes autour du chunk lue par la génération : rayon du feuillage des arbres
+// Un arbre dont le tronc est dans la marge peut déborder dans le chunk
+#define GEN_MARGIN 1
+#define GEN_AREA_X (CHUNK_SIZE_X + 2 * GEN_MARGIN)
+#define GEN_AREA_Z (CHUNK_SIZE_Z + 2 * GEN_MARGIN)
+
+// Accès aux blocs d'une colonne de sections en cours de génération (coordonnées locales)
+static inline BlockType getGenBlock(const BlockStorage sections[CHUNK_SECTIONS], int x, int y, int z) {
+    return getStorageBlock(&sections[y / SECTION_SIZE], x, y % SECTION_SIZE, z);
 }
 
-static float smoothNoise2D(float x, float z, int seed) {
-    int intX = (int)x;
-    int intZ = (int)z;
-    float fracX = x - intX;
-    float fracZ = z - intZ;
-    
-    // Interpolation bilinéaire
-    float v1 = noise2D(intX, intZ, seed);
-    float v2 = noise2D(intX + 1, intZ, seed);
-    float v3 = noise2D(intX, intZ + 1, seed);
-    float v4 = noise2D(intX + 1, intZ + 1, seed);
-    
-    float i1 = v1 * (1 - fracX) + v2 * fracX;
-    float i2 = v3 * (1 - fracX) + v4 * fracX;
+// Pose un bloc non-air et remonte le sommet de sa colonne si besoin
+static inline void setGenBlock(BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns, int x, int y, int z, BlockType type) {
+    setStorageBlock(&sections[y / SECTION_SIZE], x, y % SECTION_SIZE, z, type);
+    if(y + 1 >= columns->height[x][z]) {
+        columns->height[x][z] = (uint16_t)(y + 1);
+        columns->surface[x][z] = type;
+    }
+}
+
+// Colonnes de désert : bruit de biome au-dessus de ce seuil (environ 10% des colonnes),
+// sable en surface et sans fleurs
+#define BIOME_DESERT_THRESHOLD 0.6f
+
+static inline int isDesertColumn(const ChunkColumns* columns, int x, int z) {
+    return columns->biome[x][z] > BIOME_DESERT_THRESHOLD;
+}
+
+// Un arbre pousse sur cette colonne (environ 2% de chance)
+static inline int isTreeColumn(int worldX, int worldZ, int seed) {
+    return noise2D(worldX * 2, worldZ * 2, seed + 3000) > 0.92f;
+}
+
+// Blocs de test près du spawn, placés dans le chunk (0,0)
+// Appelé par les workers à chaque (re)génération : aucun affichage ici (voir initWorldGen)
+static void placeTestBlocks(BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns) {
+    // PLACEMENT DE TEST : Un bloc de test animé près du spawn
+    // Chunk 0,0, position locale 5,12,5 au-dessus du niveau de base du terrain (écrase le bloc en place)
+    int testID = game.blockIds.test;
+    if(testID > 0) {
+        setGenBlock(sections, columns, 5, TERRAIN_BASE_HEIGHT + 12, 5, testID);
+    }
+
+    // PLACEMENT DE TEST : Bloc de référence (TestCube)
+    int testCubeID = game.blockIds.testCube;
+    if(testCubeID > 0) {
+        setGenBlock(sections, columns, 6, TERRAIN_BASE_HEIGHT + 12, 5, testCubeID);
+    }
+}
+
+void initWorldGen(int seed) {
+    if(seed == 0) {
+        seed = time(NULL);
+    }
+    // Pas d'état global : chaque chunk ne dépend que de (seed, cx, cz)
+    game.worldSeed = seed;
     
-    return i1 * (1 - fracZ) + i2 * fracZ;
+    printf("Génération du monde avec seed: %u (bruit %s)\n", seed, noiseKernelName(bestNoiseKernel()));
+
+    // Blocs de test du chunk (0,0) (voir placeTestBlocks), signalés une seule fois
+    if(game.blockIds.test > 0) printf("TEST: Bloc 'Test' placé en (5, %d, 5)\n", TERRAIN_BASE_HEIGHT + 12);
+    else printf("TEST: Bloc 'Test' non trouvé\n");
+    if(game.blockIds.testCube > 0) printf("TEST: Bloc 'TestCube' placé en (6, %d, 5)\n", TERRAIN_BASE_HEIGHT + 12);
+    else printf("TEST: Bloc 'TestCube' non trouvé\n");
 }
 
-// Bruit de Perlin multi-octaves
-static float perlinNoise2D(float x, float z, int octaves, float persistence, int seed) {
-    float total = 0.0f;
-    float frequency = 1.0f;
-    float amplitude = 1.0f;
-    float maxValue = 0.0f;
+// Étage "bruit" : hauteurs des colonnes du chunk et de sa marge, calculées une fois
+// heights[x + GEN_MARGIN][z + GEN_MARGIN] pour x, z locaux ; min/max sur le chunk seul
+static void computeHeights(int cx, int cz, int seed, int heights[GEN_AREA_X][GEN_AREA_Z], int* minHeight, int* maxHeight) {
+    // Toute la grille en un appel : noyaux SIMD quand le processeur les supporte
+    float heightNoise[GEN_AREA_X][GEN_AREA_Z];
+    noiseGrid2D(&heightNoise[0][0], cx * CHUNK_SIZE_X - GEN_MARGIN, cz * CHUNK_SIZE_Z - GEN_MARGIN,
+                GEN_AREA_X, GEN_AREA_Z, 0.05f, 4, 0.5f, seed);
     
-    for(int i = 0; i < octaves; i++) {
-        total += smoothNoise2D(x * frequency, z * frequency, seed) * amplitude;
-        maxValue += amplitude;
-        amplitude *= persistence;
-        frequency *= 2.0f;
+    *minHeight = CHUNK_SIZE_Y;
+    *maxHeight = 0;
+    for(int x = -GEN_MARGIN; x < CHUNK_SIZE_X + GEN_MARGIN; x++) {
+        for(int z = -GEN_MARGIN; z < CHUNK_SIZE_Z + GEN_MARGIN; z++) {
+            // Variation de 0 à 10 blocs (sol = hauteur - 1)
+            int h = (int)(heightNoise[x + GEN_MARGIN][z + GEN_MARGIN] * 6.0f + 4.0f) + TERRAIN_BASE_HEIGHT;
+            heights[x + GEN_MARGIN][z + GEN_MARGIN] = h;
+            
+            if(x < 0 || x >= CHUNK_SIZE_X || z < 0 || z >= CHUNK_SIZE_Z) continue;
+            if(h < *minHeight) *minHeight = h;
+            if(h > *maxHeight) *maxHeight = h;
+        }
     }
-    
-    return total / maxValue;
 }
 
-// Fonction auxiliaire pour placer un arbre à une position donnée
-static void placeTree(Chunk **world, int worldX, int worldY, int worldZ) {
+void computeChunkBiomes(int cx, int cz, int seed, ChunkColumns* columns) {
+    // biome[x][z] : même disposition que la grille de noiseGrid2D
+    noiseGrid2D(&columns->biome[0][0], cx * CHUNK_SIZE_X, cz * CHUNK_SIZE_Z, CHUNK_SIZE_X, CHUNK_SIZE_Z,
+                0.02f, 2, 0.6f, seed + 1000);
+}
+
+// Étage "surface" : roche, terre, herbe et fleurs d'après les hauteurs, sable dans les déserts
+// Lit les biomes du cache des colonnes et le remplit, repris par les étages suivants
+static void buildSurface(int cx, int cz, int seed, int heights[GEN_AREA_X][GEN_AREA_Z], int minHeight, int maxHeight,
+                         BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns) {
+    BlockType stoneID = game.blockIds.stone;
+    BlockType dirtID = game.blockIds.dirt;
+    BlockType grassID = game.blockIds.grass;
+    BlockType flowerID = game.blockIds.flower;
+    BlockType sandID = game.blockIds.sand;
     
-    // Tronc de l'arbre (3 blocs de hauteur)
-    int trunkHeight = 3;
+    // Sommet de chaque colonne : herbe en height - 1, fleur éventuelle juste au-dessus
+    for(int x = 0; x < CHUNK_SIZE_X; x++) {
+        for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+            int height = heights[x + GEN_MARGIN][z + GEN_MARGIN];
+            
+            if(isDesertColumn(columns, x, z)) {
+                columns->height[x][z] = (uint16_t)height;
+                columns->surface[x][z] = sandID;
+                continue;
+            }
+            
+            // Végétation aléatoire sur la terre : fleurs occasionnelles
+            float vegNoise = noise2D(cx * CHUNK_SIZE_X + x, cz * CHUNK_SIZE_Z + z, seed + 2000);
+            if(vegNoise > 0.65f && height < CHUNK_SIZE_Y) {
+                columns->height[x][z] = (uint16_t)(height + 1);
+                columns->surface[x][z] = flowerID;
+            } else {
+                columns->height[x][z] = (uint16_t)height;
+                columns->surface[x][z] = grassID;
+            }
+        }
+    }
     
-    for(int y = 0; y < trunkHeight; y++) {
-        int cy = (worldY + y) / CHUNK_SIZE_Y;
-        if((worldY + y) >= CHUNK_SIZE_Y) continue; // Hors limites
+    // Tampon plat d'une section, compressé ensuite en une passe
+    BlockType *blocks = malloc(SECTION_VOLUME * sizeof(BlockType));
+    
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        int baseY = s * SECTION_SIZE;
         
-        int cx = worldX / CHUNK_SIZE_X;
-        int cz = worldZ / CHUNK_SIZE_Z;
-        int lx = worldX % CHUNK_SIZE_X;
-        int lz = worldZ % CHUNK_SIZE_Z;
+        // Sections entièrement au-dessus du sol (végétation comprise) : restent vides
+        if(baseY > maxHeight) continue;
         
-        if(cx >= 0 && cx < WORLD_CHUNKS_X && cz >= 0 && cz < WORLD_CHUNKS_Z) {
-            game.world[cx][cz].blocks[lx][worldY + y][lz].type = findBlockByName("Log");
+        // Sections entièrement dans la roche : uniformes, sans tampon
+        if(baseY + SECTION_SIZE <= minHeight - 3) {
+            fillStorage(&sections[s], stoneID);
+            continue;
         }
-    }
-    
-    // Feuilles (plus petites, rayon 1-2)
-    int leafY = worldY + trunkHeight;
-    for(int dx = -1; dx <= 1; dx++) {
-        for(int dy = -1; dy <= 1; dy++) {
-            for(int dz = -1; dz <= 1; dz++) {
-                // Distance approximative pour former une petite sphère
-                if(abs(dx) + abs(dy) + abs(dz) <= 2) {
-                    int lx = (worldX + dx) % CHUNK_SIZE_X;
-                    int ly = leafY + dy;
-                    int lz = (worldZ + dz) % CHUNK_SIZE_Z;
-                    int cx = (worldX + dx) / CHUNK_SIZE_X;
-                    int cz = (worldZ + dz) / CHUNK_SIZE_Z;
+        
+        for(int x = 0; x < CHUNK_SIZE_X; x++) {
+            for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+                int height = heights[x + GEN_MARGIN][z + GEN_MARGIN];
+                int desert = isDesertColumn(columns, x, z);
+                
+                for(int ly = 0; ly < SECTION_SIZE; ly++) {
+                    int y = baseY + ly;
+                    BlockType blockType = BLOCK_AIR;
                     
-                    if(cx >= 0 && cx < WORLD_CHUNKS_X && cz >= 0 && cz < WORLD_CHUNKS_Z &&
-                       ly >= 0 && ly < CHUNK_SIZE_Y && lx >= 0 && lx < CHUNK_SIZE_X && 
-                       lz >= 0 && lz < CHUNK_SIZE_Z) {
-                        // Ne pas remplacer le tronc
-                        if(game.world[cx][cz].blocks[lx][ly][lz].type == BLOCK_AIR) {
-                            game.world[cx][cz].blocks[lx][ly][lz].type = findBlockByName("Leaves");
-                        }
+                    if(y == 0) {
+                        // Bedrock au fond
+                        blockType = stoneID;
+                    }
+                    else if(y < height - 3) {
+                        // Pierre en profondeur
+                        blockType = stoneID;
                     }
+                    else if(y < height - 1) {
+                        // Terre sous la surface, sable dans les déserts
+                        blockType = desert ? sandID : dirtID;
+                    }
+                    else if(y == height - 1) {
+                        // Surface : herbe, ou sable dans les déserts
+                        blockType = desert ? sandID : grassID;
+                    }
+                    else if(y == height) {
+                        // Fleur choisie avec le sommet de la colonne
+                        if(columns->height[x][z] > height) blockType = flowerID;
+                    }
+                    
+                    blocks[storageIndex(x, ly, z)] = blockType;
                 }
             }
         }
+        
+        packStorage(&sections[s], blocks);
     }
+    free(blocks);
 }
 
-void generateRandomWorld(Chunk** world, int seed) {
+// Étage "décoration" : arbres dont le tronc est dans le chunk ou dans sa marge
+// Seuls les blocs qui tombent dans le chunk sont écrits : chaque voisin pose sa part
+// des arbres de la bordure lors de sa propre génération, dans n'importe quel ordre
+static void placeTrees(int cx, int cz, int seed, int heights[GEN_AREA_X][GEN_AREA_Z],
+                       BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns) {
+    BlockType logID = game.blockIds.log;
+    BlockType leavesID = game.blockIds.leaves;
     
-    if(seed == 0) {
-        seed = time(NULL);
-    }
-    srand(seed);
-    
-    printf("Génération du monde avec seed: %u\n", seed);
+    // Tronc de l'arbre (3 blocs de hauteur), posé sur le sol
+    int trunkHeight = 3;
     
-    for(int cx = 0; cx < WORLD_CHUNKS_X; cx++) {
-        for(int cz = 0; cz < WORLD_CHUNKS_Z; cz++) {
-            Chunk *chunk = &game.world[cx][cz];
+    // Troncs d'abord : ils remplacent la végétation et le feuillage des arbres voisins
+    for(int x = 0; x < CHUNK_SIZE_X; x++) {
+        for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+            if(!isTreeColumn(cx * CHUNK_SIZE_X + x, cz * CHUNK_SIZE_Z + z, seed)) continue;
             
-            for(int x = 0; x < CHUNK_SIZE_X; x++) {
-                for(int z = 0; z < CHUNK_SIZE_Z; z++) {
-                    // Position mondiale
-                    int worldX = cx * CHUNK_SIZE_X + x;
-                    int worldZ = cz * CHUNK_SIZE_Z + z;
-                    
-                    // Génération de hauteur avec bruit de Perlin
-                    float heightNoise = perlinNoise2D(worldX * 0.05f, worldZ * 0.05f, 4, 0.5f, seed);
-                    int height = (int)(heightNoise * 6.0f + 4.0f); // Hauteur entre 0 et 10
-                    
-                    // Bruit pour les biomes
-                    float biomeNoise = perlinNoise2D(worldX * 0.02f, worldZ * 0.02f, 2, 0.6f, seed + 1000);
-                    
-                    for(int y = 0; y < CHUNK_SIZE_Y; y++) {
-                        BlockType blockType = BLOCK_AIR;
-                        
-                        if(y == 0) {
-                            // Bedrock au fond
-                            blockType = findBlockByName("Stone");
-                        }
-                        else if(y < height - 3) {
-                            // Pierre en profondeur
-                            blockType = findBlockByName("Stone");
-                        }
-                        else if(y < height - 1) {
-                            // Terre sous la surface
-                            blockType = findBlockByName("Dirt");
-                        }
-                        else if(y == height - 1) {
-                            // Surface : toujours de la terre
-                            blockType = findBlockByName("Grass");
-                        }
-                        else if(y == height) {
-                            // Végétation aléatoire sur la terre
-                            float vegNoise = noise2D(worldX, worldZ, seed + 2000);
-                            
-                            // Fleurs occasionnelles sur la surface
-                            if(vegNoise > 0.65f) {
-                                blockType = findBlockByName("Flower");
-                            }
-                        }
-                        
-                        chunk->blocks[x][y][z].type = blockType;
-                    }
-                }
+            int baseY = heights[x + GEN_MARGIN][z + GEN_MARGIN];
+            for(int y = baseY; y < baseY + trunkHeight && y < CHUNK_SIZE_Y; y++) {
+                setGenBlock(sections, columns, x, y, z, logID);
             }
-            
-            chunk->needsRebuild = 1;
         }
     }
-    // Deuxième passe : placer les arbres après avoir généré le terrain
-    printf("Génération des arbres...\n");
-    for(int cx = 0; cx < WORLD_CHUNKS_X; cx++) {
-        for(int cz = 0; cz < WORLD_CHUNKS_Z; cz++) {
-            for(int x = 0; x < CHUNK_SIZE_X; x++) {
-                for(int z = 0; z < CHUNK_SIZE_Z; z++) {
-                    int worldX = cx * CHUNK_SIZE_X + x;
-                    int worldZ = cz * CHUNK_SIZE_Z + z;
-                    
-                    // Bruit pour la position des arbres
-                    float treeNoise = noise2D(worldX * 2, worldZ * 2, seed + 3000);
-                    
-                    // Arbres plus espacés (environ 2% de chance)
-                    if(treeNoise > 0.92f) {
-                        // Trouver la hauteur du sol à cette position
-                        float heightNoise = perlinNoise2D(worldX * 0.05f, worldZ * 0.05f, 4, 0.5f, seed);
-                        int height = (int)(heightNoise * 6.0f + 4.0f);
+    
+    // Feuilles (plus petites, rayon 1) : uniquement dans l'air
+    for(int tx = -GEN_MARGIN; tx < CHUNK_SIZE_X + GEN_MARGIN; tx++) {
+        for(int tz = -GEN_MARGIN; tz < CHUNK_SIZE_Z + GEN_MARGIN; tz++) {
+            if(!isTreeColumn(cx * CHUNK_SIZE_X + tx, cz * CHUNK_SIZE_Z + tz, seed)) continue;
+            
+            int leafY = heights[tx + GEN_MARGIN][tz + GEN_MARGIN] + trunkHeight;
+            for(int dx = -1; dx <= 1; dx++) {
+                for(int dy = -1; dy <= 1; dy++) {
+                    for(int dz = -1; dz <= 1; dz++) {
+                        // Distance approximative pour former une petite sphère
+                        if(abs(dx) + abs(dy) + abs(dz) > 2) continue;
+                        
+                        int x = tx + dx, y = leafY + dy, z = tz + dz;
+                        if(x < 0 || x >= CHUNK_SIZE_X || z < 0 || z >= CHUNK_SIZE_Z) continue;
+                        if(y < 0 || y >= CHUNK_SIZE_Y) continue;
                         
-                        // Placer l'arbre sur le sol (sur le bloc de terre)
-                        placeTree(world, worldX, height, worldZ);
+                        if(getGenBlock(sections, x, y, z) == BLOCK_AIR) {
+                            setGenBlock(sections, columns, x, y, z, leavesID);
+                        }
                     }
                 }
             }
         }
     }
-    
-    printf("Génération du monde terminée\n");
-    
-    // PLACEMENT DE TEST : Un bloc de test animé près du spawn
-    int testID = findBlockByName("Test");
-    if(testID > 0) {
-        // Chunk 0,0, position locale 5,12,5
-        // Assurez-vous que c'est de l'air avant (ou écrasez)
-        game.world[0][0].blocks[5][12][5].type = testID;
-        printf("TEST: Bloc 'Test' placé en (5, 12, 5)\n");
-    } else {
-        printf("TEST: Bloc 'Test' non trouvé\n");
-    }
+}
 
-    // PLACEMENT DE TEST : Bloc de référence (TestCube)
-    int testCubeID = findBlockByName("TestCube");
-    if(testCubeID > 0) {
-        game.world[0][0].blocks[6][12][5].type = testCubeID;
-        game.world[0][0].needsRebuild = 1;  // Forcer le rebuild du chunk
-        printf("TEST: Bloc 'TestCube' placé en (6, 12, 5), chunk(0,0).needsRebuild=%d\n", 
-               game.world[0][0].needsRebuild);
-    } else {
-        printf("TEST: Bloc 'TestCube' non trouvé\n");
+void generateChunk(int cx, int cz, int seed, BlockStorage sections[CHUNK_SECTIONS], ChunkColumns* columns) {
+    int heights[GEN_AREA_X][GEN_AREA_Z];
+    int minHeight, maxHeight;
+    computeHeights(cx, cz, seed, heights, &minHeight, &maxHeight);
+    computeChunkBiomes(cx, cz, seed, columns);
+    buildSurface(cx, cz, seed, heights, minHeight, maxHeight, sections, columns);
+    placeTrees(cx, cz, seed, heights, sections, columns);
+    
+    if(cx == 0 && cz == 0) {
+        placeTestBlocks(sections, columns);
     }
 }
 
-void generateFlatWorld(Chunk **world) {
-    printf("Génération d'un monde plat\n");
+void generateFlatChunk(Chunk* chunk) {
+    BlockType *blocks = malloc(SECTION_VOLUME * sizeof(BlockType));
     
-    for(int cx = 0; cx < WORLD_CHUNKS_X; cx++) {
-        for(int cz = 0; cz < WORLD_CHUNKS_Z; cz++) {
-            Chunk *chunk = &game.world[cx][cz];
-            
-            for(int x = 0; x < CHUNK_SIZE_X; x++) {
-                for(int y = 0; y < CHUNK_SIZE_Y; y++) {
-                    for(int z = 0; z < CHUNK_SIZE_Z; z++) {
-                        BlockType blockType = BLOCK_AIR;
-                        
-                        if(y == 0) {
-                            blockType = findBlockByName("Grass");
-                        }
-                        else if(y == 1 && (x + z) % 2 == 0) {
-                            blockType = findBlockByName("Stone");
-                        }
-                        else if(y == 1) {
-                            blockType = findBlockByName("Flower");
-                        }
-                        else if(y == 2 && (x + z) % 5 == 0) {
-                            blockType = findBlockByName("Flower");
-                        }
-                        else if(y == 3 && x % 4 == 0 && z % 4 == 0) {
-                            blockType = findBlockByName("Glass");
-                        }
-                        
-                        chunk->blocks[x][y][z].type = blockType;
-                    }
+    // Tout le relief tient dans la première section, les autres restent vides
+    for(int x = 0; x < CHUNK_SIZE_X; x++) {
+        for(int y = 0; y < SECTION_SIZE; y++) {
+            for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+                BlockType blockType = BLOCK_AIR;
+                
+                if(y == 0) {
+                    blockType = game.blockIds.grass;
                 }
+                else if(y == 1 && (x + z) % 2 == 0) {
+                    blockType = game.blockIds.stone;
+                }
+                else if(y == 1) {
+                    blockType = game.blockIds.flower;
+                }
+                else if(y == 2 && (x + z) % 5 == 0) {
+                    blockType = game.blockIds.flower;
+                }
+                else if(y == 3 && x % 4 == 0 && z % 4 == 0) {
+                    blockType = game.blockIds.glass;
+                }
+                
+                blocks[storageIndex(x, y, z)] = blockType;
             }
-            
-            chunk->needsRebuild = 1;
         }
     }
     
-    printf("Monde plat généré\n");
+    packStorage(privateChunkSection(chunk, 0), blocks);
+    free(blocks);
+    computeChunkColumns(chunk);
+    chunk->dirtySections = CHUNK_ALL_SECTIONS;
 }
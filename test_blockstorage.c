@@ -0,0 +1,124 @@
+// Test du stockage des sections : palette, indices bit-packés et copie avant écriture
+// Compilation et exécution : make tests
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blockstorage.h"
+
+GameContext game = {0};
+
+static int failures = 0;
+
+static void check(int condition, const char* what) {
+    if(!condition) {
+        fprintf(stderr, "ECHEC: %s\n", what);
+        failures++;
+    }
+}
+
+// Compare tout le stockage à un tableau plat de référence
+static int matches(const BlockStorage* storage, const BlockType* expected) {
+    for(int x = 0; x < SECTION_SIZE; x++) {
+        for(int y = 0; y < SECTION_SIZE; y++) {
+            for(int z = 0; z < SECTION_SIZE; z++) {
+                if(getStorageBlock(storage, x, y, z) != expected[storageIndex(x, y, z)]) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Écritures aléatoires avec un nombre de types croissant : chaque agrandissement de la palette
+// (1 -> 2 -> 4 -> 8 -> 16 bits) doit conserver les blocs déjà écrits
+static void testRandomWrites() {
+    static BlockType expected[SECTION_VOLUME];
+    BlockStorage* storage = createStorage(BLOCK_AIR);
+    for(int i = 0; i < SECTION_VOLUME; i++) expected[i] = BLOCK_AIR;
+
+    int typeCounts[] = { 2, 3, 5, 17, 300 };
+    for(int round = 0; round < 5; round++) {
+        for(int n = 0; n < 4 * SECTION_VOLUME; n++) {
+            int x = rand() % SECTION_SIZE, y = rand() % SECTION_SIZE, z = rand() % SECTION_SIZE;
+            BlockType type = (BlockType)(rand() % typeCounts[round]);
+            setStorageBlock(storage, x, y, z, type);
+            expected[storageIndex(x, y, z)] = type;
+        }
+        check(matches(storage, expected), "écritures aléatoires");
+    }
+    check(storage->bitsPerIndex == 16, "indices de 16 bits après 300 types");
+
+    fillStorage(storage, 7);
+    check(isStorageUniform(storage) && getStorageBlock(storage, 3, 4, 5) == 7, "fillStorage uniforme");
+    destroyStorage(storage);
+}
+
+// Copie avant écriture : modifier une copie (jusqu'à agrandir ses indices) ne touche jamais
+// la version publiée, que les lecteurs peuvent encore parcourir
+static void testCopyOnWrite() {
+    static BlockType expected[SECTION_VOLUME];
+    BlockStorage* published = createStorage(BLOCK_AIR);
+    for(int i = 0; i < SECTION_VOLUME; i++) {
+        expected[i] = (BlockType)(i % 3);
+        setStorageBlock(published, i / (SECTION_SIZE * SECTION_SIZE), (i / SECTION_SIZE) % SECTION_SIZE,
+                        i % SECTION_SIZE, expected[i]);
+    }
+
+    int bits = published->bitsPerIndex;
+    const uint64_t* data = published->data;
+    const BlockType* palette = published->palette;
+
+    BlockStorage* next = copyStorage(published);
+    for(int type = 3; type < 40; type++) {
+        setStorageBlock(next, type % SECTION_SIZE, 0, 0, (BlockType)type);
+    }
+
+    check(next->data != data && next->palette != palette, "la copie a ses propres tableaux");
+    check(published->bitsPerIndex == bits && published->data == data && published->palette == palette,
+          "la version publiée garde ses tableaux");
+    check(matches(published, expected), "la version publiée garde ses blocs");
+    check(getStorageBlock(next, 5, 0, 0) == 37, "la copie reçoit les écritures");
+
+    destroyStorage(next);
+    destroyStorage(published);
+}
+
+// Sérialisation puis relecture, et packStorage équivalent aux écritures une à une
+static void testSerialization() {
+    static BlockType blocks[SECTION_VOLUME];
+    static BlockType unpacked[SECTION_VOLUME];
+    static uint8_t buffer[STORAGE_MAX_SERIALIZED_SIZE];
+
+    for(int i = 0; i < SECTION_VOLUME; i++) blocks[i] = (BlockType)(rand() % 6);
+    BlockStorage packed;
+    initStorage(&packed, BLOCK_AIR);
+    packStorage(&packed, blocks);
+    check(matches(&packed, blocks), "packStorage");
+
+    unpackStorage(&packed, unpacked);
+    check(memcmp(blocks, unpacked, sizeof(blocks)) == 0, "unpackStorage");
+
+    size_t size = serializeStorage(&packed, buffer);
+    BlockStorage loaded;
+    initStorage(&loaded, BLOCK_AIR);
+    check(deserializeStorage(&loaded, buffer, size) == (int)size, "deserializeStorage");
+    check(matches(&loaded, blocks), "aller-retour sérialisé");
+    check(deserializeStorage(&loaded, buffer, size - 1) < 0, "données tronquées refusées");
+    check(matches(&loaded, blocks), "section inchangée après un refus");
+
+    freeStorage(&loaded);
+    freeStorage(&packed);
+}
+
+int main() {
+    srand(1234);
+    testRandomWrites();
+    testCopyOnWrite();
+    testSerialization();
+
+    if(failures > 0) {
+        fprintf(stderr, "test_blockstorage: %d échecs\n", failures);
+        return 1;
+    }
+    printf("test_blockstorage: OK\n");
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Test de charge des sections copy-on-write : le thread principal modifie des chunks prêts
+// pendant que des threads lecteurs en copient les sections et les maillent
+// Plus de lecteurs que l'ancienne table de 16 emplacements ; à lancer aussi sous
+// -fsanitize=address (lecture d'une version libérée) et -fsanitize=thread
+// Compilation et exécution : make tests (depuis la racine, lit blocks.block et ses textures)
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "chunk.h"
+#include "chunkmap.h"
+#include "blockparser.h"
+#include "blockstorage.h"
+#include "epoch.h"
+
+GameContext game = {0};
+
+#define TEST_CHUNKS 3
+#define READER_THREADS 20
+#define TARGET_SNAPSHOTS 600
+#define TARGET_EDITS 5000
+#define RECLAIM_INTERVAL 50
+
+static Chunk* chunks[TEST_CHUNKS];
+static atomic_int stopReaders = 0;
+static atomic_long snapshotCount = 0;
+static atomic_int invalidBlocks = 0;
+
+// Une copie ne contient que des types connus, quelle que soit la version lue
+static int isSnapshotValid(const ChunkSnapshot* snapshot) {
+    for(int s = 0; s < snapshot->sectionCount; s++) {
+        const BlockType* blocks = &snapshot->sections[s].blocks[0][0][0];
+        for(int i = 0; i < SNAPSHOT_SIZE * SNAPSHOT_SIZE * SNAPSHOT_SIZE; i++) {
+            if(blocks[i] < 0 || blocks[i] >= game.blockCount) return 0;
+        }
+    }
+    return 1;
+}
+
+static void* readerThread(void* arg) {
+    (void)arg;
+    MeshScratch scratch;
+    initMeshScratch(&scratch);
+
+    while(!atomic_load(&stopReaders)) {
+        for(int i = 0; i < TEST_CHUNKS; i++) {
+            const Chunk* neighbors[4] = { i > 0 ? chunks[i - 1] : NULL, i + 1 < TEST_CHUNKS ? chunks[i + 1] : NULL, NULL, NULL };
+            ChunkSnapshot snapshot;
+            epochEnter();
+            snapshotChunk(chunks[i], neighbors, CHUNK_ALL_SECTIONS, &snapshot);
+            epochExit();
+
+            if(!isSnapshotValid(&snapshot)) atomic_fetch_add(&invalidBlocks, 1);
+            ChunkMeshData mesh;
+            buildChunkMesh(&snapshot, &scratch, &mesh);
+            freeChunkSnapshot(&snapshot);
+            freeChunkMeshData(&mesh);
+            atomic_fetch_add(&snapshotCount, 1);
+        }
+    }
+
+    freeMeshScratch(&scratch);
+    return NULL;
+}
+
+int main() {
+    if(parseBlocksFromFile("blocks.block") < 0) {
+        fprintf(stderr, "test_epoch_stress: blocks.block introuvable (lancer depuis la racine du dépôt)\n");
+        return 1;
+    }
+    compileBlockModels();
+    game.world = createChunkMap(64);
+
+    for(int i = 0; i < TEST_CHUNKS; i++) {
+        chunks[i] = allocChunk(game.world);
+        chunks[i]->cx = i;
+        chunks[i]->cz = 0;
+        chunks[i]->genStage = CHUNK_STAGE_READY;
+    }
+
+    pthread_t readers[READER_THREADS];
+    for(int t = 0; t < READER_THREADS; t++) {
+        pthread_create(&readers[t], NULL, readerThread, NULL);
+    }
+
+    // Thread principal (seul écrivain) : modifications aléatoires sur 4 sections, récupération régulière
+    srand(1);
+    long edits = 0;
+    while(edits < TARGET_EDITS || atomic_load(&snapshotCount) < TARGET_SNAPSHOTS) {
+        Chunk* chunk = chunks[rand() % TEST_CHUNKS];
+        setChunkBlock(chunk, rand() % CHUNK_SIZE_X, rand() % (4 * SECTION_SIZE), rand() % CHUNK_SIZE_Z,
+                      (BlockType)(rand() % game.blockCount));
+        if(++edits % RECLAIM_INTERVAL == 0) epochReclaim();
+    }
+
+    atomic_store(&stopReaders, 1);
+    for(int t = 0; t < READER_THREADS; t++) {
+        pthread_join(readers[t], NULL);
+    }
+
+    for(int i = 0; i < TEST_CHUNKS; i++) {
+        releaseChunk(game.world, chunks[i]);
+    }
+    destroyChunkMap(game.world);
+    epochReclaimAll();
+    freeBlockModels();
+
+    if(atomic_load(&invalidBlocks) > 0) {
+        fprintf(stderr, "test_epoch_stress: %d copies avec des blocs invalides\n", atomic_load(&invalidBlocks));
+        return 1;
+    }
+    printf("test_epoch_stress: OK (%ld modifications, %ld copies, %d lecteurs)\n",
+           edits, atomic_load(&snapshotCount), READER_THREADS);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Test du système de jobs : emplacements des threads, y compris ceux demandés avant
+// initJobSystem et gardés après un arrêt et un redémarrage, et découpage de parallelFor
+// À lancer aussi sous -fsanitize=thread (deux propriétaires pour une même file)
+// Compilation et exécution : make tests
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "jobsystem.h"
+
+#define TEST_CYCLES 3
+#define TEST_JOBS 200
+#define TEST_FOR_MAX 5000
+
+static atomic_int failures = 0;
+
+static void check(int condition, const char* what) {
+    if(!condition) {
+        fprintf(stderr, "ECHEC: %s\n", what);
+        failures++;
+    }
+}
+
+// Emplacement du thread qui exécute le job
+static void recordSlot(void* data) {
+    *(int*)data = jobThreadSlot();
+}
+
+// Emplacements des threads hors workers qui attendent des jobs, et peuvent donc en exécuter
+static int mainSlot = -1, helperSlot = -1;
+
+// Jobs soumis puis attendus par le thread appelant : chacun tourne sur un worker ou sur un
+// thread qui attend (file globale partagée)
+static int checkJobSlots() {
+    int slots[TEST_JOBS];
+    JobCounter counter = JOB_COUNTER_INIT;
+    for(int i = 0; i < TEST_JOBS; i++) {
+        submitJob(recordSlot, &slots[i], &counter);
+    }
+    waitForJobs(&counter);
+
+    for(int i = 0; i < TEST_JOBS; i++) {
+        int isWorker = slots[i] >= 0 && slots[i] < jobWorkerCount();
+        if(!isWorker && slots[i] != mainSlot && slots[i] != helperSlot) return 0;
+    }
+    return 1;
+}
+
+// Tableau rempli par parallelFor : nombre d'écritures par indice
+typedef struct {
+    atomic_int writes[TEST_FOR_MAX];
+    int grain;                 // Taille maximale attendue d'une tranche
+    atomic_int oversized;      // Tranches plus grandes ou hors de [0, count)
+    int count;
+} ForTest;
+
+static void fillRange(int begin, int end, void* data) {
+    ForTest* test = data;
+    if(begin < 0 || end > test->count || begin >= end || end - begin > test->grain) {
+        atomic_fetch_add(&test->oversized, 1);
+        return;
+    }
+    for(int i = begin; i < end; i++) atomic_fetch_add(&test->writes[i], 1);
+}
+
+// Chaque indice de [0, count) écrit exactement une fois, quels que soient count et grain
+static void checkParallelFor(const char* when) {
+    static ForTest test;
+    const int counts[] = { 0, 1, 7, 64, 1000, TEST_FOR_MAX };
+    const int grains[] = { 0, 1, 3, 64, 10000 };
+    for(unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        for(unsigned g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+            for(int i = 0; i < TEST_FOR_MAX; i++) atomic_store(&test.writes[i], 0);
+            atomic_store(&test.oversized, 0);
+            test.count = counts[c];
+            // Sans workers, une seule tranche couvre tout [0, count)
+            test.grain = (jobWorkerCount() == 0) ? counts[c] : (grains[g] < 1 ? 1 : grains[g]);
+            parallelFor(counts[c], grains[g], fillRange, &test);
+
+            int wrong = atomic_load(&test.oversized);
+            for(int i = 0; i < TEST_FOR_MAX; i++) {
+                if(atomic_load(&test.writes[i]) != (i < counts[c])) wrong++;
+            }
+            if(wrong > 0) {
+                fprintf(stderr, "ECHEC: parallelFor %s (count %d, grain %d) : %d erreurs\n",
+                        when, counts[c], grains[g], wrong);
+                atomic_fetch_add(&failures, 1);
+            }
+        }
+    }
+}
+
+// Thread qui prend son emplacement avant initJobSystem et soumet des jobs à chaque cycle
+static pthread_barrier_t cycleStart, cycleEnd;
+
+static void* helperThread(void* arg) {
+    (void)arg;
+    helperSlot = jobThreadSlot();
+    for(int cycle = 0; cycle < TEST_CYCLES; cycle++) {
+        pthread_barrier_wait(&cycleStart);
+        check(jobThreadSlot() == helperSlot, "emplacement du thread auxiliaire changé");
+        check(checkJobSlots(), "job du thread auxiliaire hors des emplacements attendus");
+        pthread_barrier_wait(&cycleEnd);
+    }
+    return NULL;
+}
+
+int main() {
+    // Emplacements demandés avant le démarrage des workers
+    mainSlot = jobThreadSlot();
+    // Sans workers : tout s'exécute sur le thread appelant
+    checkParallelFor("sans workers");
+    pthread_barrier_init(&cycleStart, NULL, 2);
+    pthread_barrier_init(&cycleEnd, NULL, 2);
+    pthread_t helper;
+    pthread_create(&helper, NULL, helperThread, NULL);
+
+    int workers = 0;
+    for(int cycle = 0; cycle < TEST_CYCLES; cycle++) {
+        initJobSystem();
+        workers = jobWorkerCount();
+        pthread_barrier_wait(&cycleStart);
+
+        check(jobThreadSlot() == mainSlot, "emplacement du thread principal changé");
+        check(mainSlot >= JOB_MAX_WORKERS && helperSlot >= JOB_MAX_WORKERS,
+              "emplacement hors workers dans la plage réservée aux workers");
+        check(mainSlot != helperSlot, "deux threads sur le même emplacement");
+        check(jobWorkerCount() > 0 && jobWorkerCount() <= JOB_MAX_WORKERS, "nombre de workers hors limites");
+        check(checkJobSlots(), "job du thread principal hors des emplacements attendus");
+        checkParallelFor("avec workers");
+
+        pthread_barrier_wait(&cycleEnd);
+        stopJobSystem();
+    }
+
+    pthread_join(helper, NULL);
+    pthread_barrier_destroy(&cycleStart);
+    pthread_barrier_destroy(&cycleEnd);
+
+    if(atomic_load(&failures) > 0) {
+        fprintf(stderr, "test_jobsystem: %d échecs\n", atomic_load(&failures));
+        return 1;
+    }
+    printf("test_jobsystem: OK (%d workers, %d cycles)\n", workers, TEST_CYCLES);
+    return 0;
+}
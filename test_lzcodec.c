@@ -0,0 +1,71 @@
+// Test de lzcodec : aller-retour sur des données variées et décodage de données corrompues
+// Compilation et exécution : make tests
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lzcodec.h"
+
+#define ROUNDS 5000
+#define MAX_SIZE 20000
+
+// Données de test : octets aléatoires (incompressibles), petit alphabet, ou longues répétitions
+static void fillSample(uint8_t* data, size_t size, int kind) {
+    for(size_t i = 0; i < size; i++) {
+        switch(kind) {
+            case 0: data[i] = (uint8_t)rand(); break;
+            case 1: data[i] = (uint8_t)(rand() % 3); break;
+            default: data[i] = (i % 7 == 0 || i == 0) ? (uint8_t)rand() : data[i - 1]; break;
+        }
+    }
+}
+
+int main() {
+    srand(1234);
+    uint8_t* source = malloc(MAX_SIZE);
+    uint8_t* compressed = malloc(lzCompressBound(MAX_SIZE));
+    uint8_t* decoded = malloc(MAX_SIZE);
+    int failures = 0;
+
+    for(int round = 0; round < ROUNDS; round++) {
+        size_t size = (round == 0) ? 0 : (size_t)(rand() % MAX_SIZE);
+        fillSample(source, size, round % 3);
+
+        size_t compressedSize = lzCompress(source, size, compressed);
+        if(compressedSize > lzCompressBound(size)) {
+            fprintf(stderr, "ECHEC: %zu octets compressés en %zu (borne %zu)\n", size, compressedSize, lzCompressBound(size));
+            failures++;
+        }
+        if(lzDecompress(compressed, compressedSize, decoded, size) != 0 || memcmp(source, decoded, size) != 0) {
+            fprintf(stderr, "ECHEC: aller-retour de %zu octets (type %d)\n", size, round % 3);
+            failures++;
+        }
+        if(compressedSize == 0) continue;
+
+        // Données tronquées ou altérées : le décodeur peut réussir ou échouer, mais ne doit jamais
+        // lire ni écrire hors des tampons (vérifié sous -fsanitize=address)
+        if(lzDecompress(compressed, compressedSize / 2, decoded, size) == 0 && size > 0 && compressedSize > 2) {
+            fprintf(stderr, "ECHEC: données tronquées acceptées (%zu octets)\n", size);
+            failures++;
+        }
+        compressed[rand() % compressedSize] ^= (uint8_t)(1 + rand() % 255);
+        lzDecompress(compressed, compressedSize, decoded, size);
+
+        // Taille attendue différente de la taille réelle : toujours refusée
+        if(size > 0 && lzDecompress(compressed, compressedSize, decoded, size - 1) == 0 &&
+           lzDecompress(compressed, compressedSize, decoded, size) == 0) {
+            fprintf(stderr, "ECHEC: deux tailles acceptées pour le même bloc\n");
+            failures++;
+        }
+    }
+
+    free(source);
+    free(compressed);
+    free(decoded);
+
+    if(failures > 0) {
+        fprintf(stderr, "test_lzcodec: %d échecs\n", failures);
+        return 1;
+    }
+    printf("test_lzcodec: OK\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Test des fichiers de région : aller-retour de chunks, réécriture, réouverture et blobs corrompus
+// Compilation et exécution : make tests
+#define _DEFAULT_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "blockstorage.h"
+#include "chunkmap.h"
+#include "region.h"
+
+GameContext game = {0};
+
+#define TEST_BLOCK_COUNT 40
+#define CORRUPTION_ROUNDS 400
+
+// Même découpage que region.c (format décrit dans region.h)
+typedef struct {
+    uint32_t sectorOffset;
+    uint32_t sectorCount;
+} TestRegionEntry;
+
+static ChunkMap* map;
+static char worldDir[] = "/tmp/test_region.XXXXXX";
+static int failures = 0;
+
+static void check(int condition, const char* what, int cx, int cz) {
+    if(!condition) {
+        fprintf(stderr, "ECHEC: %s (chunk %d, %d)\n", what, cx, cz);
+        failures++;
+    }
+}
+
+static int floorDiv(int c) {
+    return (c >= 0) ? c / REGION_SIZE : (c + 1) / REGION_SIZE - 1;
+}
+
+// Contenu déterministe d'un chunk : sol en couches, blocs épars dont la densité dépend de variant
+static Chunk* makeChunk(int cx, int cz, int variant) {
+    Chunk* chunk = allocChunk(map);
+    chunk->cx = cx;
+    chunk->cz = cz;
+    srand((unsigned)(cx * 7919 + cz * 104729 + variant));
+    int groundSections = 2 + variant % 5;
+    for(int s = 0; s < groundSections; s++) {
+        BlockStorage* section = privateChunkSection(chunk, s);
+        fillStorage(section, 1 + s);
+        int scattered = (variant % 3) * 600;
+        for(int i = 0; i < scattered; i++) {
+            setStorageBlock(section, rand() % SECTION_SIZE, rand() % SECTION_SIZE, rand() % SECTION_SIZE,
+                            (BlockType)(rand() % TEST_BLOCK_COUNT));
+        }
+    }
+    return chunk;
+}
+
+static int sameBlocks(const Chunk* a, const Chunk* b) {
+    for(int y = 0; y < CHUNK_SIZE_Y; y++) {
+        for(int x = 0; x < CHUNK_SIZE_X; x++) {
+            for(int z = 0; z < CHUNK_SIZE_Z; z++) {
+                if(getChunkBlock(a, x, y, z) != getChunkBlock(b, x, y, z)) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Un chunk relu doit toujours être utilisable : types connus, ou entièrement à l'air s'il est refusé
+static int isUsable(const Chunk* chunk, int loaded) {
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        const BlockStorage* section = chunkSection(chunk, s);
+        if(!loaded && !isStorageEmpty(section)) return 0;
+        for(int i = 0; i < section->paletteSize; i++) {
+            if(section->palette[i] < 0 || section->palette[i] >= game.blockCount) return 0;
+        }
+    }
+    return 1;
+}
+
+static int loadInto(int cx, int cz, Chunk** out) {
+    Chunk* chunk = allocChunk(map);
+    chunk->cx = cx;
+    chunk->cz = cz;
+    int loaded = loadChunkFromRegion(chunk);
+    *out = chunk;
+    return loaded;
+}
+
+static void regionPath(int cx, int cz, char* path, size_t size) {
+    snprintf(path, size, "%s/r.%d.%d.reg", worldDir, floorDiv(cx), floorDiv(cz));
+}
+
+static TestRegionEntry readEntry(int cx, int cz) {
+    char path[512];
+    regionPath(cx, cz, path, sizeof(path));
+    int index = (cz - floorDiv(cz) * REGION_SIZE) * REGION_SIZE + (cx - floorDiv(cx) * REGION_SIZE);
+    TestRegionEntry entry = {0, 0};
+    int fd = open(path, O_RDONLY);
+    if(fd >= 0) {
+        if(pread(fd, &entry, sizeof(entry), index * sizeof(entry)) != (ssize_t)sizeof(entry)) entry.sectorCount = 0;
+        close(fd);
+    }
+    return entry;
+}
+
+static void writeBytes(int cx, int cz, off_t offset, const void* bytes, size_t size) {
+    char path[512];
+    regionPath(cx, cz, path, sizeof(path));
+    int fd = open(path, O_RDWR);
+    if(fd < 0 || pwrite(fd, bytes, size, offset) != (ssize_t)size) {
+        fprintf(stderr, "ECHEC: écriture dans %s\n", path);
+        failures++;
+    }
+    if(fd >= 0) close(fd);
+}
+
+// Chunks répartis sur plusieurs régions, coordonnées négatives comprises
+static void testRoundTrip() {
+    const int coords[][2] = { {0, 0}, {1, 0}, {31, 31}, {32, 0}, {-1, -1}, {-33, 5}, {100, -70}, {-32, -32} };
+    int count = sizeof(coords) / sizeof(coords[0]);
+
+    for(int i = 0; i < count; i++) {
+        Chunk* chunk = makeChunk(coords[i][0], coords[i][1], i);
+        check(saveChunkToRegion(chunk) == 0, "sauvegarde", chunk->cx, chunk->cz);
+        releaseChunk(map, chunk);
+    }
+
+    // Réouverture des fichiers : les données viennent du disque
+    closeRegionStorage();
+    for(int i = 0; i < count; i++) {
+        Chunk* expected = makeChunk(coords[i][0], coords[i][1], i);
+        Chunk* loaded;
+        check(loadInto(coords[i][0], coords[i][1], &loaded) == 1, "chargement", coords[i][0], coords[i][1]);
+        check(sameBlocks(expected, loaded), "blocs relus", coords[i][0], coords[i][1]);
+        releaseChunk(map, expected);
+        releaseChunk(map, loaded);
+    }
+
+    Chunk* missing;
+    check(loadInto(2, 3, &missing) == 0 && isUsable(missing, 0), "chunk jamais sauvegardé", 2, 3);
+    releaseChunk(map, missing);
+
+    // Réécritures plus grandes (ajout en fin de fichier) puis plus petites (sur place)
+    for(int variant = 0; variant < 6; variant++) {
+        Chunk* chunk = makeChunk(5, 7, variant);
+        check(saveChunkToRegion(chunk) == 0, "réécriture", 5, 7);
+        Chunk* loaded;
+        check(loadInto(5, 7, &loaded) == 1 && sameBlocks(chunk, loaded), "réécriture relue", 5, 7);
+        releaseChunk(map, chunk);
+        releaseChunk(map, loaded);
+    }
+}
+
+// Octets altérés dans le blob, en-tête incohérent ou entrée de table hors du fichier :
+// le chunk est soit chargé avec des types valides, soit refusé et laissé à l'air
+static void testCorruption() {
+    const int cx = 9, cz = -4;
+    for(int round = 0; round < CORRUPTION_ROUNDS; round++) {
+        Chunk* chunk = makeChunk(cx, cz, round % 6);
+        saveChunkToRegion(chunk);
+        releaseChunk(map, chunk);
+
+        TestRegionEntry entry = readEntry(cx, cz);
+        off_t start = (off_t)entry.sectorOffset * REGION_SECTOR_SIZE;
+        size_t length = (size_t)entry.sectorCount * REGION_SECTOR_SIZE;
+        srand((unsigned)round);
+
+        switch(round % 4) {
+            case 0:
+            case 1: {
+                // Quelques octets au hasard : début du blob (en-tête compris), puis n'importe où
+                size_t span = (round % 4 == 0) ? 64 : length;
+                int flips = 1 + rand() % 8;
+                for(int i = 0; i < flips; i++) {
+                    uint8_t byte = (uint8_t)rand();
+                    writeBytes(cx, cz, start + (off_t)(rand() % span), &byte, 1);
+                }
+                break;
+            }
+            case 2: {
+                // Tailles de l'en-tête hors limites
+                uint32_t sizes[2] = { (uint32_t)rand(), (uint32_t)rand() % (uint32_t)(2 * length) };
+                writeBytes(cx, cz, start, sizes, sizeof(sizes));
+                break;
+            }
+            default: {
+                // Entrée de table pointant sur l'en-tête de la région ou au-delà de la fin du fichier
+                int index = (cz - floorDiv(cz) * REGION_SIZE) * REGION_SIZE + (cx - floorDiv(cx) * REGION_SIZE);
+                TestRegionEntry bogus = { (round % 8 == 3) ? 0 : entry.sectorOffset + 1000, entry.sectorCount };
+                writeBytes(cx, cz, index * sizeof(bogus), &bogus, sizeof(bogus));
+                // La table est lue à l'ouverture de la région
+                closeRegionStorage();
+                break;
+            }
+        }
+
+        Chunk* loaded;
+        int result = loadInto(cx, cz, &loaded);
+        check(isUsable(loaded, result), "chunk corrompu utilisable", cx, cz);
+        releaseChunk(map, loaded);
+
+        // Repartir d'une entrée saine pour le tour suivant
+        if(round % 4 == 3) {
+            int index = (cz - floorDiv(cz) * REGION_SIZE) * REGION_SIZE + (cx - floorDiv(cx) * REGION_SIZE);
+            writeBytes(cx, cz, index * sizeof(entry), &entry, sizeof(entry));
+            closeRegionStorage();
+        }
+    }
+}
+
+static void removeWorldDir() {
+    closeRegionStorage();
+    DIR* dir = opendir(worldDir);
+    if(!dir) return;
+    struct dirent* file;
+    while((file = readdir(dir)) != NULL) {
+        if(file->d_name[0] == '.') continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", worldDir, file->d_name);
+        unlink(path);
+    }
+    closedir(dir);
+    rmdir(worldDir);
+}
+
+int main() {
+    if(!mkdtemp(worldDir) || initRegionStorage(worldDir) != 0) {
+        fprintf(stderr, "test_region: impossible de créer %s\n", worldDir);
+        return 1;
+    }
+    game.blockCount = TEST_BLOCK_COUNT;
+    map = createChunkMap(16);
+
+    testRoundTrip();
+    testCorruption();
+
+    destroyChunkMap(map);
+    removeWorldDir();
+
+    if(failures > 0) {
+        fprintf(stderr, "test_region: %d échecs\n", failures);
+        return 1;
+    }
+    printf("test_region: OK\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Test du remaillage par section : après des modifications aléatoires (surtout aux bordures des
+// chunks et des sections), le mesh tenu à jour en ne reconstruisant que les sections marquées
+// doit être identique, section par section, à un remaillage complet
+// Compilation et exécution : make tests (depuis la racine, lit blocks.block et ses textures)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chunk.h"
+#include "chunkmap.h"
+#include "blockparser.h"
+#include "blockstorage.h"
+#include "epoch.h"
+#include "world.h"
+#include "worldgen.h"
+
+GameContext game = {0};
+
+#define TEST_SEED 12345
+#define TEST_ROUNDS 300
+#define TEST_RADIUS 1
+#define TEST_CHUNKS ((2 * TEST_RADIUS + 1) * (2 * TEST_RADIUS + 1))
+
+// Mesh d'une section dans une passe, tel qu'il serait uploadé
+typedef struct {
+    ChunkVertex* vertices;
+    int count;
+} SectionMesh;
+
+typedef struct {
+    Chunk* chunk;
+    SectionMesh sections[CHUNK_SECTIONS][RENDER_LAYER_COUNT];
+} TrackedChunk;
+
+static TrackedChunk tracked[TEST_CHUNKS];
+static MeshScratch scratch;
+
+// Construit le mesh des sections de sectionMask, comme un job de maillage
+static void buildMesh(Chunk* chunk, uint16_t sectionMask, ChunkMeshData* out) {
+    const Chunk* neighbors[4];
+    ChunkSnapshot snapshot;
+    getChunkNeighbors(chunk, neighbors);
+    snapshotChunk(chunk, neighbors, sectionMask, &snapshot);
+    buildChunkMesh(&snapshot, &scratch, out);
+    freeChunkSnapshot(&snapshot);
+}
+
+// Remplace les sections reconstruites, comme uploadChunkMesh
+static void applyMesh(TrackedChunk* entry, const ChunkMeshData* data) {
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        if(!((data->sectionMask >> s) & 1)) continue;
+        for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+            SectionMesh* mesh = &entry->sections[s][layer];
+            int start = data->sectionStart[layer][s];
+            mesh->count = data->sectionStart[layer][s + 1] - start;
+            free(mesh->vertices);
+            mesh->vertices = malloc(mesh->count * sizeof(ChunkVertex) + 1);
+            if(mesh->count > 0) memcpy(mesh->vertices, data->vertices[layer] + start, mesh->count * sizeof(ChunkVertex));
+        }
+    }
+}
+
+// Chunk généré, prêt et inséré dans la table
+static Chunk* loadTestChunk(int cx, int cz) {
+    Chunk* chunk = allocChunk(game.world);
+    chunk->cx = cx;
+    chunk->cz = cz;
+
+    BlockStorage sections[CHUNK_SECTIONS];
+    for(int s = 0; s < CHUNK_SECTIONS; s++) initStorage(&sections[s], BLOCK_AIR);
+    generateChunk(cx, cz, TEST_SEED, sections, &chunk->columns);
+    for(int s = 0; s < CHUNK_SECTIONS; s++) {
+        BlockStorage* section = privateChunkSection(chunk, s);
+        freeStorage(section);
+        *section = sections[s];
+    }
+
+    chunk->genStage = CHUNK_STAGE_READY;
+    chunkMapInsert(game.world, chunk);
+    return chunk;
+}
+
+// Coordonnée monde X ou Z d'un bloc modifié : une fois sur deux de part et d'autre d'une
+// frontière entre deux chunks chargés
+static int randomEditCoord(int chunkSize) {
+    if(rand() % 2) return -TEST_RADIUS * chunkSize + rand() % ((2 * TEST_RADIUS + 1) * chunkSize);
+    int border = (rand() % (2 * TEST_RADIUS) - TEST_RADIUS + 1) * chunkSize;
+    return border - rand() % 2;
+}
+
+int main() {
+    if(parseBlocksFromFile("blocks.block") < 0) {
+        fprintf(stderr, "test_remesh: blocks.block introuvable (lancer depuis la racine du dépôt)\n");
+        return 1;
+    }
+    compileBlockModels();
+    initMeshScratch(&scratch);
+    game.world = createChunkMap(64);
+
+    int count = 0;
+    for(int cx = -TEST_RADIUS; cx <= TEST_RADIUS; cx++) {
+        for(int cz = -TEST_RADIUS; cz <= TEST_RADIUS; cz++) {
+            tracked[count++].chunk = loadTestChunk(cx, cz);
+        }
+    }
+    for(int i = 0; i < TEST_CHUNKS; i++) {
+        ChunkMeshData data;
+        buildMesh(tracked[i].chunk, CHUNK_ALL_SECTIONS, &data);
+        applyMesh(&tracked[i], &data);
+        freeChunkMeshData(&data);
+        tracked[i].chunk->dirtySections = 0;
+    }
+
+    srand(5);
+    int mismatches = 0, edits = 0, remeshed = 0;
+    for(int round = 0; round < TEST_ROUNDS && mismatches == 0; round++) {
+        // Quelques modifications par tour, publiées ensemble comme en fin de frame
+        int editCount = 1 + rand() % 4;
+        for(int e = 0; e < editCount; e++) {
+            int x = randomEditCoord(CHUNK_SIZE_X);
+            int z = randomEditCoord(CHUNK_SIZE_Z);
+            // Y : près du relief, une fois sur deux de part et d'autre d'une frontière de sections
+            int y = (rand() % 2) ? rand() % 100 : (TERRAIN_BASE_HEIGHT / SECTION_SIZE + rand() % 2) * SECTION_SIZE - rand() % 2;
+            BlockType type = (rand() % 2) ? BLOCK_AIR : (BlockType)(1 + rand() % (game.blockCount - 1));
+            edits += setWorldBlock(x, y, z, type);
+        }
+        flushBlockEdits();
+        epochReclaim();
+
+        // Remaillage incrémental : seules les sections marquées
+        for(int i = 0; i < TEST_CHUNKS; i++) {
+            Chunk* chunk = tracked[i].chunk;
+            uint16_t dirty = atomic_exchange(&chunk->dirtySections, 0);
+            if(!dirty) continue;
+            ChunkMeshData data;
+            buildMesh(chunk, dirty, &data);
+            applyMesh(&tracked[i], &data);
+            freeChunkMeshData(&data);
+            remeshed++;
+        }
+
+        // Référence : remaillage complet de chaque chunk
+        for(int i = 0; i < TEST_CHUNKS; i++) {
+            ChunkMeshData data;
+            buildMesh(tracked[i].chunk, CHUNK_ALL_SECTIONS, &data);
+            for(int s = 0; s < CHUNK_SECTIONS; s++) {
+                for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+                    const SectionMesh* mesh = &tracked[i].sections[s][layer];
+                    int start = data.sectionStart[layer][s];
+                    int expected = data.sectionStart[layer][s + 1] - start;
+                    if(mesh->count != expected || (expected > 0 &&
+                       memcmp(mesh->vertices, data.vertices[layer] + start, expected * sizeof(ChunkVertex)) != 0)) {
+                        fprintf(stderr, "ECHEC: tour %d, chunk (%d, %d), section %d, passe %d : %d sommets au lieu de %d\n",
+                                round, tracked[i].chunk->cx, tracked[i].chunk->cz, s, layer, mesh->count, expected);
+                        mismatches++;
+                    }
+                }
+            }
+            freeChunkMeshData(&data);
+        }
+    }
+
+    for(int i = 0; i < TEST_CHUNKS; i++) {
+        for(int s = 0; s < CHUNK_SECTIONS; s++) {
+            for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) free(tracked[i].sections[s][layer].vertices);
+        }
+        chunkMapRemove(game.world, tracked[i].chunk);
+        releaseChunk(game.world, tracked[i].chunk);
+    }
+    destroyChunkMap(game.world);
+    epochReclaimAll();
+    freeMeshScratch(&scratch);
+    freeBlockModels();
+
+    if(mismatches > 0 || edits == 0) {
+        fprintf(stderr, "test_remesh: %d sections différentes (%d modifications)\n", mismatches, edits);
+        return 1;
+    }
+    printf("test_remesh: OK (%d modifications, %d remaillages)\n", edits, remeshed);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Test des passes de rendu et du mode de culling déclarés dans blocks.block
+// Chaque bloc est maillé seul dans l'air puis en section pleine : ses quads doivent arriver dans
+// sa passe (renderLayer) avec sa couche de texture, et ses faces suivre son mode de culling
+// Compilation et exécution : make tests (depuis la racine, lit blocks.block et ses textures)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chunk.h"
+#include "blockstorage.h"
+#include "blockparser.h"
+
+GameContext game = {0};
+
+static int failures = 0;
+
+static void check(int condition, const BlockDefinition* def, const char* what) {
+    if(!condition) {
+        fprintf(stderr, "ECHEC: bloc '%s' : %s\n", def->name, what);
+        failures++;
+    }
+}
+
+// Maille une section remplie par fill(x, y, z) (coordonnées du snapshot, bordure comprise)
+static void meshSection(SectionSnapshot* section, BlockType (*fill)(int x, int y, int z, BlockType type),
+                        BlockType type, MeshScratch* scratch, ChunkMeshData* out) {
+    // Section au-dessus du fond du monde, fermé quel que soit le contenu
+    section->sectionY = 1;
+    for(int x = 0; x < SNAPSHOT_SIZE; x++) {
+        for(int y = 0; y < SNAPSHOT_SIZE; y++) {
+            for(int z = 0; z < SNAPSHOT_SIZE; z++) {
+                section->blocks[x][y][z] = fill(x, y, z, type);
+            }
+        }
+    }
+    ChunkSnapshot snapshot = { (uint16_t)(1u << section->sectionY), section, 1 };
+    buildChunkMesh(&snapshot, scratch, out);
+}
+
+static BlockType isolatedBlock(int x, int y, int z, BlockType type) {
+    return (x == 8 && y == 8 && z == 8) ? type : BLOCK_AIR;
+}
+
+static BlockType filledSection(int x, int y, int z, BlockType type) {
+    (void)x; (void)y; (void)z;
+    return type;
+}
+
+static int vertexCount(const ChunkMeshData* mesh, int layer) {
+    return mesh->sectionStart[layer][CHUNK_SECTIONS];
+}
+
+// Tous les sommets dans la passe du bloc, avec sa couche de texture
+static int inOwnLayer(const ChunkMeshData* mesh, const BlockDefinition* def) {
+    for(int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+        if(layer != (int)def->renderLayer && vertexCount(mesh, layer) != 0) return 0;
+    }
+    for(int i = 0; i < vertexCount(mesh, def->renderLayer); i++) {
+        if((int)(mesh->vertices[def->renderLayer][i].texture >> 20) != def->textureLayer) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    if(parseBlocksFromFile("blocks.block") < 0) {
+        fprintf(stderr, "test_render_layers: blocks.block introuvable (lancer depuis la racine du dépôt)\n");
+        return 1;
+    }
+    compileBlockModels();
+
+    MeshScratch scratch;
+    initMeshScratch(&scratch);
+    SectionSnapshot* section = malloc(sizeof(SectionSnapshot));
+    int tested = 0;
+
+    for(int i = 1; i < game.blockCount; i++) {
+        const BlockDefinition* def = &game.blocks[i];
+        if(def->isDynamic || !def->bakedModel) continue;
+        int modelVertices = def->bakedModel->faceStart[BAKED_FACE_LISTS];
+        ChunkMeshData mesh;
+
+        // Seul dans l'air : aucune face cachée, quel que soit le mode
+        meshSection(section, isolatedBlock, (BlockType)i, &scratch, &mesh);
+        int isolated = vertexCount(&mesh, def->renderLayer);
+        check(isolated > 0, def, "aucun sommet pour un bloc isolé");
+        check(inOwnLayer(&mesh, def), def, "sommets hors de sa passe ou de sa couche de texture");
+        if(def->cullMode == CULL_MODE_NONE) {
+            check(isolated == modelVertices, def, "culling \"none\" : faces du modèle manquantes");
+        }
+        freeChunkMeshData(&mesh);
+
+        // Section pleine du même bloc, bordure comprise
+        meshSection(section, filledSection, (BlockType)i, &scratch, &mesh);
+        int filled = vertexCount(&mesh, def->renderLayer);
+        check(inOwnLayer(&mesh, def), def, "section pleine : sommets hors de sa passe");
+        if(def->cullMode == CULL_MODE_NONE) {
+            // Toutes les faces de chaque bloc, voisins ou non
+            check(filled == modelVertices * SECTION_VOLUME, def, "culling \"none\" : faces éliminées");
+        } else if(!def->transparent || def->translucent) {
+            // Opaque : chaque face touche un voisin opaque ; translucide : un voisin identique
+            check(filled == 0, def, "culling \"faces\" : faces internes maillées");
+        } else {
+            // Transparent (feuillage) : les faces restent visibles à travers les voisins
+            check(filled > 0, def, "bloc transparent : faces internes éliminées");
+        }
+        freeChunkMeshData(&mesh);
+        tested++;
+    }
+
+    free(section);
+    freeMeshScratch(&scratch);
+    freeBlockModels();
+    check(tested > 0, &game.blocks[0], "aucun bloc maillé");
+
+    if(failures > 0) {
+        fprintf(stderr, "test_render_layers: %d échecs\n", failures);
+        return 1;
+    }
+    printf("test_render_layers: OK (%d blocs)\n", tested);
+    return 0;
+}